@@ -2,32 +2,88 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <utility>
 
 #include "atom/app/uv_task_runner.h"
 
-#include "base/stl_util.h"
-
 namespace atom {
 
-UvTaskRunner::UvTaskRunner(uv_loop_t* loop) : loop_(loop) {
+namespace {
+
+template <typename T>
+void DeleteHandle(uv_handle_t* handle) {
+  delete reinterpret_cast<T*>(handle);
+}
+
+}  // namespace
+
+UvTaskRunner::DelayedTask::DelayedTask(uint64_t run_time,
+                                       uint64_t sequence_num,
+                                       base::OnceClosure task)
+    : run_time(run_time),
+      sequence_num(sequence_num),
+      task(std::move(task)) {
+}
+
+UvTaskRunner::DelayedTask::DelayedTask(DelayedTask&& other) = default;
+
+UvTaskRunner::DelayedTask::~DelayedTask() {
+}
+
+UvTaskRunner::DelayedTask& UvTaskRunner::DelayedTask::operator=(
+    DelayedTask&& other) = default;
+
+bool UvTaskRunner::DelayedTask::operator<(const DelayedTask& other) const {
+  if (run_time != other.run_time)
+    return run_time > other.run_time;
+  return sequence_num > other.sequence_num;
+}
+
+UvTaskRunner::UvTaskRunner(uv_loop_t* loop)
+    : loop_(loop),
+      check_(new uv_check_t),
+      idle_(new uv_idle_t),
+      timer_(new uv_timer_t),
+      next_sequence_num_(0) {
+  uv_check_init(loop_, check_);
+  check_->data = this;
+  uv_idle_init(loop_, idle_);
+  idle_->data = this;
+  uv_timer_init(loop_, timer_);
+  timer_->data = this;
 }
 
 UvTaskRunner::~UvTaskRunner() {
-  for (auto& iter : tasks_) {
-    uv_unref(reinterpret_cast<uv_handle_t*>(iter.first));
-    delete iter.first;
-  }
+  // The handles stay linked into the loop until they are closed. When the
+  // loop never runs again they are leaked, which is still better than
+  // leaving freed memory in its handle queue.
+  uv_close(reinterpret_cast<uv_handle_t*>(check_), DeleteHandle<uv_check_t>);
+  uv_close(reinterpret_cast<uv_handle_t*>(idle_), DeleteHandle<uv_idle_t>);
+  uv_close(reinterpret_cast<uv_handle_t*>(timer_), DeleteHandle<uv_timer_t>);
 }
 
 bool UvTaskRunner::PostDelayedTask(const tracked_objects::Location& from_here,
                                    base::OnceClosure task,
                                    base::TimeDelta delay) {
-  auto* timer = new uv_timer_t;
-  timer->data = this;
-  uv_timer_init(loop_, timer);
-  uv_timer_start(timer, UvTaskRunner::OnTimeout, delay.InMilliseconds(), 0);
-  tasks_[timer] = std::move(task);
+  int64_t delay_ms = delay.InMilliseconds();
+  if (delay_ms <= 0) {
+    if (immediate_tasks_.empty()) {
+      uv_check_start(check_, UvTaskRunner::OnCheck);
+      // Keeps the loop from blocking in poll before the check handle runs.
+      uv_idle_start(idle_, UvTaskRunner::OnIdle);
+    }
+    immediate_tasks_.push_back(std::move(task));
+    return true;
+  }
+
+  delayed_tasks_.emplace_back(uv_now(loop_) + delay_ms, next_sequence_num_++,
+                              std::move(task));
+  std::push_heap(delayed_tasks_.begin(), delayed_tasks_.end());
+
+  // Only a new earliest task moves the timer.
+  if (delayed_tasks_.front().sequence_num == next_sequence_num_ - 1)
+    ScheduleTimer();
   return true;
 }
 
@@ -42,21 +98,57 @@ bool UvTaskRunner::PostNonNestableDelayedTask(
   return PostDelayedTask(from_here, std::move(task), delay);
 }
 
-// static
-void UvTaskRunner::OnTimeout(uv_timer_t* timer) {
-  UvTaskRunner* self = static_cast<UvTaskRunner*>(timer->data);
-  if (!ContainsKey(self->tasks_, timer))
+void UvTaskRunner::RunImmediateTasks() {
+  // Tasks posted by these tasks wait for the next loop iteration, so that
+  // they can not starve I/O.
+  size_t count = immediate_tasks_.size();
+  for (size_t i = 0; i < count; ++i) {
+    base::OnceClosure task = std::move(immediate_tasks_.front());
+    immediate_tasks_.pop_front();
+    std::move(task).Run();
+  }
+
+  if (immediate_tasks_.empty()) {
+    uv_check_stop(check_);
+    uv_idle_stop(idle_);
+  }
+}
+
+void UvTaskRunner::RunDelayedTasks() {
+  uint64_t now = uv_now(loop_);
+  while (!delayed_tasks_.empty() && delayed_tasks_.front().run_time <= now) {
+    std::pop_heap(delayed_tasks_.begin(), delayed_tasks_.end());
+    base::OnceClosure task = std::move(delayed_tasks_.back().task);
+    delayed_tasks_.pop_back();
+    std::move(task).Run();
+  }
+  ScheduleTimer();
+}
+
+void UvTaskRunner::ScheduleTimer() {
+  if (delayed_tasks_.empty()) {
+    uv_timer_stop(timer_);
     return;
+  }
+
+  uint64_t now = uv_now(loop_);
+  uint64_t run_time = delayed_tasks_.front().run_time;
+  uv_timer_start(timer_, UvTaskRunner::OnTimeout,
+                 run_time > now ? run_time - now : 0, 0);
+}
+
+// static
+void UvTaskRunner::OnCheck(uv_check_t* check) {
+  static_cast<UvTaskRunner*>(check->data)->RunImmediateTasks();
+}
 
-  std::move(self->tasks_[timer]).Run();
-  self->tasks_.erase(timer);
-  uv_timer_stop(timer);
-  uv_close(reinterpret_cast<uv_handle_t*>(timer), UvTaskRunner::OnClose);
+// static
+void UvTaskRunner::OnIdle(uv_idle_t* idle) {
 }
 
 // static
-void UvTaskRunner::OnClose(uv_handle_t* handle) {
-  delete reinterpret_cast<uv_timer_t*>(handle);
+void UvTaskRunner::OnTimeout(uv_timer_t* timer) {
+  static_cast<UvTaskRunner*>(timer->data)->RunDelayedTasks();
 }
 
 }  // namespace atom
@@ -5,7 +5,10 @@
 #ifndef ATOM_APP_UV_TASK_RUNNER_H_
 #define ATOM_APP_UV_TASK_RUNNER_H_
 
-#include <map>
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/single_thread_task_runner.h"
@@ -14,6 +17,11 @@
 namespace atom {
 
 // TaskRunner implementation that posts tasks into libuv's default loop.
+//
+// Tasks without a delay are queued and run from a check handle once per loop
+// iteration, while delayed tasks are kept in a min-heap driven by a single
+// timer. The handles are only active while there are tasks, so they keep
+// the loop alive just like the pending tasks would.
 class UvTaskRunner : public base::SingleThreadTaskRunner {
  public:
   explicit UvTaskRunner(uv_loop_t* loop);
@@ -31,12 +39,41 @@ class UvTaskRunner : public base::SingleThreadTaskRunner {
       base::TimeDelta delay) override;
 
  private:
+  struct DelayedTask {
+    DelayedTask(uint64_t run_time,
+                uint64_t sequence_num,
+                base::OnceClosure task);
+    DelayedTask(DelayedTask&& other);
+    ~DelayedTask();
+    DelayedTask& operator=(DelayedTask&& other);
+
+    // Orders the heap so that the earliest task, and of tasks due at the
+    // same time the first posted one, is on top.
+    bool operator<(const DelayedTask& other) const;
+
+    uint64_t run_time;
+    uint64_t sequence_num;
+    base::OnceClosure task;
+  };
+
+  void RunImmediateTasks();
+  void RunDelayedTasks();
+  void ScheduleTimer();
+
+  static void OnCheck(uv_check_t* check);
+  static void OnIdle(uv_idle_t* idle);
   static void OnTimeout(uv_timer_t* timer);
-  static void OnClose(uv_handle_t* handle);
 
   uv_loop_t* loop_;
 
-  std::map<uv_timer_t*, base::OnceClosure> tasks_;
+  // Heap allocated, so that they can outlive the runner until closed.
+  uv_check_t* check_;
+  uv_idle_t* idle_;
+  uv_timer_t* timer_;
+
+  std::deque<base::OnceClosure> immediate_tasks_;
+  std::vector<DelayedTask> delayed_tasks_;
+  uint64_t next_sequence_num_;
 
   DISALLOW_COPY_AND_ASSIGN(UvTaskRunner);
 };
@@ -0,0 +1,140 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/app/uv_task_runner.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace atom {
+
+namespace {
+
+void CountHandle(uv_handle_t* handle, void* arg) {
+  ++*static_cast<int*>(arg);
+}
+
+int CountHandles(uv_loop_t* loop) {
+  int count = 0;
+  uv_walk(loop, CountHandle, &count);
+  return count;
+}
+
+class UvTaskRunnerTest : public testing::Test {
+ protected:
+  UvTaskRunnerTest() : loop_(&loop_storage_) {
+    uv_loop_init(loop_);
+    runner_ = new UvTaskRunner(loop_);
+  }
+
+  ~UvTaskRunnerTest() override {
+    // Running the loop lets the closed handles of the runner be freed, and
+    // the loop can only be closed once they are.
+    runner_ = nullptr;
+    uv_run(loop_, UV_RUN_DEFAULT);
+    EXPECT_EQ(0, uv_loop_close(loop_));
+  }
+
+  void Post(int id, int delay_ms = 0) {
+    runner_->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(&UvTaskRunnerTest::Record, base::Unretained(this), id),
+        base::TimeDelta::FromMilliseconds(delay_ms));
+  }
+
+  void Record(int id) { ran_.push_back(id); }
+
+  // Posts the next task from the running one, so that every task costs a
+  // loop iteration.
+  void PostChained(int remaining) {
+    if (remaining == 0)
+      return;
+    runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&UvTaskRunnerTest::PostChained, base::Unretained(this),
+                       remaining - 1));
+  }
+
+  uv_loop_t loop_storage_;
+  uv_loop_t* loop_;
+  scoped_refptr<UvTaskRunner> runner_;
+  std::vector<int> ran_;
+};
+
+void Increment(int* count) {
+  ++*count;
+}
+
+}  // namespace
+
+TEST_F(UvTaskRunnerTest, RunsImmediateTasksInPostOrder) {
+  Post(1);
+  Post(2);
+  Post(3);
+  uv_run(loop_, UV_RUN_DEFAULT);
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), ran_);
+}
+
+TEST_F(UvTaskRunnerTest, RunsDelayedTasksByRunTimeThenPostOrder) {
+  Post(1, 20);
+  Post(2, 10);
+  Post(3, 10);
+  Post(4);
+  uv_run(loop_, UV_RUN_DEFAULT);
+  EXPECT_EQ(std::vector<int>({4, 2, 3, 1}), ran_);
+}
+
+TEST_F(UvTaskRunnerTest, LoopStopsWhenNoTasksAreLeft) {
+  Post(1, 5);
+  EXPECT_NE(0, uv_run(loop_, UV_RUN_NOWAIT));
+  uv_run(loop_, UV_RUN_DEFAULT);
+  EXPECT_EQ(0, uv_loop_alive(loop_));
+}
+
+TEST_F(UvTaskRunnerTest, DestroyedRunnerClosesItsHandles) {
+  EXPECT_EQ(3, CountHandles(loop_));
+  Post(1);
+  Post(2, 10);
+  runner_ = nullptr;
+
+  // The handles are closing, and are gone after one pass of the loop.
+  EXPECT_EQ(3, CountHandles(loop_));
+  EXPECT_NE(0, uv_loop_alive(loop_));
+  EXPECT_EQ(0, uv_run(loop_, UV_RUN_NOWAIT));
+  EXPECT_EQ(0, CountHandles(loop_));
+  EXPECT_EQ(0, uv_loop_close(loop_));
+  EXPECT_TRUE(ran_.empty());
+
+  // Lets the fixture close it again.
+  uv_loop_init(loop_);
+}
+
+TEST_F(UvTaskRunnerTest, PostTaskThroughput) {
+  const int kTasks = 100000;
+
+  int count = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kTasks; ++i)
+    runner_->PostTask(FROM_HERE, base::BindOnce(&Increment, &count));
+  uv_run(loop_, UV_RUN_DEFAULT);
+  base::TimeDelta batched = base::TimeTicks::Now() - start;
+  EXPECT_EQ(kTasks, count);
+
+  start = base::TimeTicks::Now();
+  PostChained(kTasks);
+  uv_run(loop_, UV_RUN_DEFAULT);
+  base::TimeDelta chained = base::TimeTicks::Now() - start;
+
+  perf_test::PrintResult("uv_task_runner", "", "batched",
+                         kTasks / batched.InSecondsF(), "tasks/s", true);
+  perf_test::PrintResult("uv_task_runner", "", "chained",
+                         kTasks / chained.InSecondsF(), "tasks/s", true);
+}
+
+}  // namespace atom
@@ -794,11 +794,28 @@ void App::SendMemoryPressureAlert() {
       base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
 }
 
+v8::Local<v8::Value> App::GetEventEmitterInfo(v8::Isolate* isolate) {
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  for (const auto& it : mate::GetEmitCounts()) {
+    mate::Dictionary counts = mate::Dictionary::CreateEmpty(isolate);
+    counts.Set("emitted", static_cast<double>(it.second.emitted));
+    counts.Set("skipped", static_cast<double>(it.second.skipped));
+    dict.Set(it.first, counts);
+  }
+  return dict.GetHandle();
+}
+
 void App::PostMessage(int worker_id,
                       v8::Local<v8::Value> message,
                       mate::Arguments* args) {
-  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message))
-    args->ThrowError("Eror serializing message");
+  // Optional Array of ArrayBuffers to transfer.
+  v8::Local<v8::Value> transfer_list;
+  args->GetNext(&transfer_list);
+
+  std::string error;
+  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message,
+                                        transfer_list, &error))
+    args->ThrowError("Error serializing message: " + error);
 }
 
 void App::StopWorker(mate::Arguments* args) {
@@ -955,6 +972,7 @@ void App::BuildPrototype(
       .SetMethod("isAccessibilitySupportEnabled",
                  &App::IsAccessibilitySupportEnabled)
       .SetMethod("sendMemoryPressureAlert", &App::SendMemoryPressureAlert)
+      .SetMethod("getEventEmitterInfo", &App::GetEventEmitterInfo)
       .SetMethod("_postMessage", &App::PostMessage)
       .SetMethod("_startWorker", &App::StartWorker)
       .SetMethod("stopWorker", &App::StopWorker)
@@ -125,6 +125,7 @@ class App : public AtomBrowserClient::Delegate,
   void DisableHardwareAcceleration(mate::Arguments* args);
   bool IsAccessibilitySupportEnabled();
   void SendMemoryPressureAlert();
+  v8::Local<v8::Value> GetEventEmitterInfo(v8::Isolate* isolate);
   void PostMessage(int worker_id,
                   v8::Local<v8::Value> message,
                   mate::Arguments* args);
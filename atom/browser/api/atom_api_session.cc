@@ -39,6 +39,7 @@
 #include "base/threading/thread_task_runner_handle.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/browser/brave_permission_manager.h"
+#include "brightray/browser/url_request_context_getter.h"
 #include "chrome/browser/devtools/devtools_network_conditions.h"
 #include "chrome/browser/devtools/devtools_network_controller_handle.h"
 #include "chrome/browser/history/history_service_factory.h"
@@ -122,6 +123,11 @@ void SetEnableBrotliInIO(scoped_refptr<net::URLRequestContextGetter> getter,
   getter->GetURLRequestContext()->set_enable_brotli(enabled);
 }
 
+void FlushNetworkStateInIO(scoped_refptr<net::URLRequestContextGetter> getter) {
+  static_cast<brightray::URLRequestContextGetter*>(getter.get())
+      ->FlushNetworkState();
+}
+
 }  // namespace
 
 namespace mate {
@@ -437,6 +443,9 @@ void Session::FlushStorageData() {
   auto storage_partition =
       content::BrowserContext::GetStoragePartition(profile_, nullptr);
   storage_partition->Flush();
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&FlushNetworkStateInIO, request_context_getter_));
 }
 
 void Session::SetProxy(const net::ProxyConfig& config,
@@ -685,6 +694,36 @@ namespace {
 
 using atom::api::Session;
 
+void OnGetSharedNetworkSessionInfo(
+    const base::Callback<void(const base::DictionaryValue&)>& callback,
+    std::unique_ptr<base::DictionaryValue> info) {
+  callback.Run(*info);
+}
+
+std::unique_ptr<base::DictionaryValue> GetSharedNetworkSessionInfoInIO() {
+  brightray::SharedNetworkSessionStats stats;
+  brightray::URLRequestContextGetter::GetSharedNetworkSessionStats(&stats);
+
+  std::unique_ptr<base::DictionaryValue> info(new base::DictionaryValue);
+  info->SetInteger("partitions", stats.partitions);
+  info->SetInteger("idleSockets", stats.idle_sockets);
+  info->SetInteger("idleSSLSockets", stats.idle_ssl_sockets);
+  info->SetInteger("hostCacheEntries",
+                   static_cast<int>(stats.host_cache_entries));
+  info->SetDouble("reusedConnections",
+                  static_cast<double>(stats.reused_connections));
+  info->SetDouble("tlsHandshakes", static_cast<double>(stats.tls_handshakes));
+  return info;
+}
+
+void GetSharedNetworkSessionInfo(
+    const base::Callback<void(const base::DictionaryValue&)>& callback) {
+  content::BrowserThread::PostTaskAndReplyWithResult(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&GetSharedNetworkSessionInfoInIO),
+      base::Bind(&OnGetSharedNetworkSessionInfo, callback));
+}
+
 v8::Local<v8::Value> FromPartition(
     const std::string& partition, mate::Arguments* args) {
   if (!atom::Browser::Get()->is_ready()) {
@@ -693,6 +732,17 @@ v8::Local<v8::Value> FromPartition(
   }
   base::DictionaryValue options;
   args->GetNext(&options);
+  // The shared network session can not keep the network state of persistent
+  // partitions on disk.
+  bool share_network_session = false;
+  options.GetBoolean("shared_network_session", &share_network_session);
+  if (share_network_session &&
+      (partition.empty() || base::StartsWith(partition, "persist:",
+                                             base::CompareCase::SENSITIVE))) {
+    args->ThrowError(
+        "shared_network_session can only be used with in-memory partitions");
+    return v8::Null(args->isolate());
+  }
   return Session::FromPartition(args->isolate(), partition, options).ToV8();
 }
 
@@ -702,6 +752,7 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   mate::Dictionary dict(isolate, exports);
   dict.Set("Session", Session::GetConstructor(isolate)->GetFunction());
   dict.SetMethod("fromPartition", &FromPartition);
+  dict.SetMethod("getSharedNetworkSessionInfo", &GetSharedNetworkSessionInfo);
   dict.SetMethod("getAllSessions",
                            &mate::TrackableObject<Session>::GetAll);
 }
@@ -2,6 +2,7 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
@@ -49,6 +50,7 @@
 #include "brave/browser/plugins/brave_plugin_service_filter.h"
 #include "brave/browser/renderer_preferences_helper.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
+#include "brave/common/serialized_args.h"
 #include "brightray/browser/inspectable_web_contents.h"
 #include "brightray/browser/inspectable_web_contents_view.h"
 #include "chrome/browser/browser_process.h"
@@ -318,6 +320,13 @@ namespace api {
 
 namespace {
 
+// A batch is delivered early once it holds this many events, so that a
+// burst of resources does not build up an arbitrarily large array.
+const uint32_t kMaxBatchedEvents = 256;
+
+// Roughly one batch per frame by default.
+const int kDefaultBatchIntervalMs = 16;
+
 mate::Handle<api::Session> SessionFromOptions(v8::Isolate* isolate,
     const mate::Dictionary& options) {
   mate::Handle<api::Session> session;
@@ -372,7 +381,12 @@ WebContents::WebContents(v8::Isolate* isolate,
       request_id_(0),
       enable_devtools_(true),
       is_being_destroyed_(false),
-      guest_delegate_(nullptr) {
+      guest_delegate_(nullptr),
+      batched_event_count_(0),
+      batched_events_total_(0),
+      batches_total_(0),
+      largest_batch_(0),
+      full_batches_(0) {
   if (type == REMOTE) {
     Init(isolate);
     AttachAsUserData(web_contents);
@@ -391,7 +405,12 @@ WebContents::WebContents(v8::Isolate* isolate,
     request_id_(0),
     enable_devtools_(true),
     is_being_destroyed_(false),
-    guest_delegate_(nullptr) {
+    guest_delegate_(nullptr),
+    batched_event_count_(0),
+    batched_events_total_(0),
+    batches_total_(0),
+    largest_batch_(0),
+    full_batches_(0) {
   CreateWebContents(isolate, options, create_params);
 }
 
@@ -400,7 +419,12 @@ WebContents::WebContents(v8::Isolate* isolate, const mate::Dictionary& options)
       request_id_(0),
       enable_devtools_(true),
       is_being_destroyed_(false),
-      guest_delegate_(nullptr) {
+      guest_delegate_(nullptr),
+      batched_event_count_(0),
+      batched_events_total_(0),
+      batches_total_(0),
+      largest_batch_(0),
+      full_batches_(0) {
   mate::Handle<api::Session> session = SessionFromOptions(isolate, options);
 
   content::WebContents::CreateParams create_params(session->browser_context());
@@ -1172,7 +1196,7 @@ void WebContents::DidFailLoad(content::RenderFrameHost* render_frame_host,
 void WebContents::DidGetResourceResponseStart(
     const content::ResourceRequestDetails& details) {
   const net::HttpResponseHeaders* headers = details.headers.get();
-  Emit("did-get-response-details",
+  EmitBatched("did-get-response-details",
        details.socket_address.IsEmpty(),
        details.url,
        details.original_url,
@@ -1186,7 +1210,7 @@ void WebContents::DidGetResourceResponseStart(
 void WebContents::DidGetRedirectForResourceRequest(
     const content::ResourceRedirectDetails& details) {
   const net::HttpResponseHeaders* headers = details.headers.get();
-  Emit("did-get-redirect-request",
+  EmitBatched("did-get-redirect-request",
        details.url,
        details.new_url,
        (details.resource_type == content::RESOURCE_TYPE_MAIN_FRAME),
@@ -1324,6 +1348,10 @@ bool WebContents::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_Message_Sync,
                                     OnRendererMessageSync)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Shared, OnRendererMessageShared)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Serialized,
+                        OnRendererMessageSerialized)
+    IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_Message_Sync_Serialized,
+                                    OnRendererMessageSyncSerialized)
     IPC_MESSAGE_HANDLER_CODE(ViewHostMsg_SetCursor, OnCursorChange,
       handled = false)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -2056,19 +2084,28 @@ bool WebContents::ExecuteScriptInTab(mate::Arguments* args) {
 #endif
 
 bool WebContents::SendIPCSharedMemory(const base::string16& channel,
-                                      base::SharedMemory* shared_memory) {
-  base::SharedMemoryHandle memory_handle = shared_memory->handle().Duplicate();
-  if (!memory_handle.IsValid())
+                                      brave::SharedMemoryWrapper* shared) {
+  AtomMsg_SharedSegment segment;
+  if (!shared || !shared->Share(&segment))
     return false;
 
-  return Send(
-      new AtomViewMsg_Message_Shared(routing_id(), channel, memory_handle));
+  return Send(new AtomViewMsg_Message_Shared(routing_id(), channel, segment));
 }
 
 bool WebContents::SendIPCMessage(bool all_frames,
                                  const base::string16& channel,
-                                 const base::ListValue& args) {
-  return Send(new AtomViewMsg_Message(routing_id(), all_frames, channel, args));
+                                 v8::Local<v8::Value> args) {
+  AtomMsg_SerializedArgs serialized;
+  if (brave::SerializeArgs(isolate(), args, &serialized))
+    return Send(new AtomViewMsg_Message_Serialized(
+        routing_id(), all_frames, channel, serialized));
+
+  // Arguments that can not be cloned, like functions, are still converted
+  // the old way.
+  base::ListValue list;
+  if (!mate::ConvertFromV8(isolate(), args, &list))
+    return false;
+  return Send(new AtomViewMsg_Message(routing_id(), all_frames, channel, list));
 }
 
 void WebContents::SendInputEvent(v8::Isolate* isolate,
@@ -2217,6 +2254,78 @@ v8::Local<v8::Value> WebContents::GetWebPreferences(v8::Isolate* isolate) {
   return mate::ConvertToV8(isolate, *web_preferences->web_preferences());
 }
 
+void WebContents::SetEventBatching(mate::Arguments* args) {
+  bool enabled;
+  if (!args->GetNext(&enabled)) {
+    args->ThrowError("Must pass a Boolean");
+    return;
+  }
+
+  if (!enabled) {
+    FlushBatchedEvents();
+    batch_interval_ = base::TimeDelta();
+    return;
+  }
+
+  int interval = kDefaultBatchIntervalMs;
+  args->GetNext(&interval);
+  batch_interval_ = base::TimeDelta::FromMilliseconds(std::max(interval, 1));
+}
+
+v8::Local<v8::Value> WebContents::GetEventBatchingInfo(v8::Isolate* isolate) {
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("enabled", !batch_interval_.is_zero());
+  dict.Set("interval", batch_interval_.InMilliseconds());
+  dict.Set("pending", batched_event_count_);
+  dict.Set("events", static_cast<double>(batched_events_total_));
+  dict.Set("batches", static_cast<double>(batches_total_));
+  dict.Set("largestBatch", largest_batch_);
+  dict.Set("fullBatches", static_cast<double>(full_batches_));
+  return dict.GetHandle();
+}
+
+void WebContents::QueueBatchedEvent(
+    const std::vector<v8::Local<v8::Value>>& values) {
+  v8::Local<v8::Array> event = v8::Array::New(isolate(), values.size());
+  for (size_t i = 0; i < values.size(); ++i)
+    event->Set(static_cast<uint32_t>(i), values[i]);
+
+  if (batched_events_.IsEmpty())
+    batched_events_.Reset(isolate(), v8::Array::New(isolate()));
+  batched_events_.Get(isolate())->Set(batched_event_count_++, event);
+  ++batched_events_total_;
+
+  if (batched_event_count_ >= kMaxBatchedEvents) {
+    ++full_batches_;
+    FlushBatchedEvents();
+  } else if (!batch_timer_.IsRunning()) {
+    batch_timer_.Start(FROM_HERE, batch_interval_,
+                       base::Bind(&WebContents::FlushBatchedEvents,
+                                  base::Unretained(this)));
+  }
+}
+
+void WebContents::FlushBatchedEvents() {
+  if (batched_event_count_ == 0)
+    return;
+
+  batch_timer_.Stop();
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Array> events = batched_events_.Get(isolate());
+  batched_events_.Reset();
+  largest_batch_ = std::max(largest_batch_, batched_event_count_);
+  batched_event_count_ = 0;
+  ++batches_total_;
+
+  // webContents.emit('event-batch', new Event(), [[name, args...], ...]);
+  Emit("event-batch", events);
+}
+
+void WebContents::WillEmit() {
+  FlushBatchedEvents();
+}
+
 v8::Local<v8::Value> WebContents::GetOwnerBrowserWindow() {
   if (owner_window())
     return Window::From(isolate(), owner_window());
@@ -2391,6 +2500,8 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isGuest", &WebContents::IsGuest)
       .SetMethod("getType", &WebContents::GetType)
       .SetMethod("getWebPreferences", &WebContents::GetWebPreferences)
+      .SetMethod("setEventBatching", &WebContents::SetEventBatching)
+      .SetMethod("getEventBatchingInfo", &WebContents::GetEventBatchingInfo)
       .SetMethod("getOwnerBrowserWindow", &WebContents::GetOwnerBrowserWindow)
       .SetMethod("hasServiceWorker", &WebContents::HasServiceWorker)
       .SetMethod("unregisterServiceWorker",
@@ -2474,16 +2585,47 @@ void WebContents::OnRendererMessageSync(const base::string16& channel,
 }
 
 void WebContents::OnRendererMessageShared(const base::string16& channel,
-                                         const base::SharedMemoryHandle& handle) {
+                                         const AtomMsg_SharedSegment& segment) {
   std::vector<v8::Local<v8::Value>> args = {
     mate::StringToV8(isolate(), channel),
-    brave::SharedMemoryWrapper::CreateFrom(isolate(), handle).ToV8(),
+    brave::SharedMemoryWrapper::CreateFrom(isolate(), segment).ToV8(),
   };
 
   // webContents.emit(channel, new Event(), args...);
   Emit("ipc-message", args);
 }
 
+void WebContents::OnRendererMessageSerialized(
+    const base::string16& channel,
+    const AtomMsg_SerializedArgs& args) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> value;
+  if (!brave::DeserializeArgs(isolate(), args, true).ToLocal(&value) ||
+      !value->IsArray())
+    return;
+
+  // webContents.emit(channel, new Event(), args...);
+  Emit(base::UTF16ToUTF8(channel), value);
+}
+
+void WebContents::OnRendererMessageSyncSerialized(
+    const base::string16& channel,
+    const AtomMsg_SerializedArgs& args,
+    IPC::Message* message) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> value;
+  if (!brave::DeserializeArgs(isolate(), args, true).ToLocal(&value) ||
+      !value->IsArray()) {
+    mate::Event::SendEmptyReply(web_contents(), message);
+    return;
+  }
+
+  // webContents.emit(channel, new Event(sender, message), args...);
+  EmitWithSender(base::UTF16ToUTF8(channel), web_contents(), message, value);
+}
+
 // static
 mate::Handle<WebContents> WebContents::FromTabID(v8::Isolate* isolate,
     int tab_id) {
@@ -14,6 +14,7 @@
 #include "atom/browser/common_web_contents_delegate.h"
 #include "atom/common/options_switches.h"
 #include "base/memory/memory_pressure_listener.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/ui/tabs/tab_strip_model_observer.h"
 #include "content/common/cursors/webcursor.h"
 #include "content/common/view_messages.h"
@@ -26,21 +27,19 @@
 
 class ProtocolHandler;
 class TabStripModel;
+struct AtomMsg_SerializedArgs;
+struct AtomMsg_SharedSegment;
 
 namespace autofill {
 class AtomAutofillClient;
 }
 
-namespace base {
-class SharedMemory;
-class SharedMemoryHandle;
-}
-
 namespace blink {
 struct WebDeviceEmulationParams;
 }
 
 namespace brave {
+class SharedMemoryWrapper;
 class TabViewGuest;
 }
 
@@ -255,9 +254,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Send messages to browser.
   bool SendIPCMessage(bool all_frames,
                       const base::string16& channel,
-                      const base::ListValue& args);
+                      v8::Local<v8::Value> args);
   bool SendIPCSharedMemory(const base::string16& channel,
-                            base::SharedMemory* shared_memory);
+                            brave::SharedMemoryWrapper* shared);
 
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
@@ -296,6 +295,10 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Returns the web preferences of current WebContents.
   v8::Local<v8::Value> GetWebPreferences(v8::Isolate* isolate);
 
+  // Delivers high-frequency events as one "event-batch" event.
+  void SetEventBatching(mate::Arguments* args);
+  v8::Local<v8::Value> GetEventBatchingInfo(v8::Isolate* isolate);
+
   // Returns the owner window.
   v8::Local<v8::Value> GetOwnerBrowserWindow();
 
@@ -505,6 +508,32 @@ class WebContents : public mate::TrackableObject<WebContents>,
     return ++request_id_;
   }
 
+  // Queues [name, args...] for the next "event-batch" event when batching is
+  // enabled and listened to, or emits it right away otherwise.
+  template<typename... Args>
+  void EmitBatched(const base::StringPiece& name, const Args&... args) {
+    if (batch_interval_.is_zero() || !HasListeners("event-batch")) {
+      Emit(name, args...);
+      return;
+    }
+
+    v8::Locker locker(isolate());
+    v8::HandleScope handle_scope(isolate());
+    std::vector<v8::Local<v8::Value>> values = {
+      mate::StringToV8(isolate(), name),
+      mate::ConvertToV8(isolate(), args)...,
+    };
+    QueueBatchedEvent(values);
+  }
+
+  void QueueBatchedEvent(const std::vector<v8::Local<v8::Value>>& values);
+  void FlushBatchedEvents();
+
+  // mate::EventEmitter:
+  // Delivers batched events before any other event, so that listeners see
+  // the events in the order they happened.
+  void WillEmit() override;
+
   // Called when we receive a CursorChange message from chromium.
   void OnCursorChange(const content::WebCursor& cursor);
 
@@ -518,7 +547,17 @@ class WebContents : public mate::TrackableObject<WebContents>,
                              IPC::Message* message);
 
   void OnRendererMessageShared(const base::string16& channel,
-                               const base::SharedMemoryHandle& shared_memory);
+                               const AtomMsg_SharedSegment& segment);
+
+  // Called when received a message with structured clone arguments.
+  void OnRendererMessageSerialized(const base::string16& channel,
+                                   const AtomMsg_SerializedArgs& args);
+
+  // Called when received a synchronous message with structured clone
+  // arguments.
+  void OnRendererMessageSyncSerialized(const base::string16& channel,
+                                       const AtomMsg_SerializedArgs& args,
+                                       IPC::Message* message);
 
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
@@ -538,6 +577,20 @@ class WebContents : public mate::TrackableObject<WebContents>,
   guest_view::GuestViewBase* guest_delegate_;  // not owned
 
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  // Events waiting for the next "event-batch", batching is disabled while
+  // the interval is zero.
+  v8::Global<v8::Array> batched_events_;
+  uint32_t batched_event_count_;
+  base::TimeDelta batch_interval_;
+  base::OneShotTimer batch_timer_;
+
+  // Back-pressure counters reported by getEventBatchingInfo().
+  uint64_t batched_events_total_;
+  uint64_t batches_total_;
+  uint32_t largest_batch_;
+  uint64_t full_batches_;
+
   DISALLOW_COPY_AND_ASSIGN(WebContents);
 };
 
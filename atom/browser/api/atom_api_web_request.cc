@@ -4,7 +4,11 @@
 
 #include "atom/browser/api/atom_api_web_request.h"
 
+#include <string>
+#include <vector>
+
 #include "atom/browser/net/atom_network_delegate.h"
+#include "atom/browser/net/web_request_rules.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -64,6 +68,18 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+void SetRulesOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter,
+    std::unique_ptr<WebRequestRules> rules) {
+  auto delegate = static_cast<AtomNetworkDelegate*>(
+      getter->GetURLRequestContext()->network_delegate());
+  delegate->SetRulesInIO(std::move(rules));
+}
+
+}  // namespace
+
 WebRequest::WebRequest(v8::Isolate* isolate,
                        Profile* profile)
     : profile_(profile) {
@@ -147,6 +163,30 @@ void WebRequest::Fetch(mate::Arguments* args) {
   fetchers_[fetcher] = FetchCallback(callback);
 }
 
+void WebRequest::SetRules(mate::Arguments* args) {
+  // Array of rules or null.
+  base::ListValue list;
+  std::unique_ptr<WebRequestRules> rules;
+  v8::Local<v8::Value> value;
+  if (args->GetNext(&list)) {
+    std::string error;
+    rules = WebRequestRules::Create(list, &error);
+    if (!rules) {
+      args->ThrowError(error);
+      return;
+    }
+  } else if (!(args->GetNext(&value) && value->IsNull())) {
+    args->ThrowError("Must pass null or an Array of rules");
+    return;
+  }
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&SetRulesOnIOThread,
+                 scoped_refptr<net::URLRequestContextGetter>(
+                     profile_->GetRequestContext()),
+                 base::Passed(&rules)));
+}
+
 template<AtomNetworkDelegate::SimpleEvent type>
 void WebRequest::SetSimpleListener(mate::Arguments* args) {
   SetListener<AtomNetworkDelegate::SimpleListener>(
@@ -162,20 +202,36 @@ void WebRequest::SetResponseListener(mate::Arguments* args) {
 template<typename Listener, typename Method, typename Event>
 void WebRequest::SetListenerOnIOThread(
     const scoped_refptr<net::URLRequestContextGetter>& getter,
-    Method method, Event type, URLPatterns patterns, Listener listener) {
+    Method method, Event type, URLPatterns patterns, uint32_t fields,
+    Listener listener) {
   auto delegate = static_cast<AtomNetworkDelegate*>(
       getter->GetURLRequestContext()->network_delegate());
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
                             base::Bind(method, base::Unretained(delegate),
-                            type, patterns, listener));
+                            type, patterns, fields, listener));
 }
 
 template<typename Listener, typename Method, typename Event>
 void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
-  // { urls }.
+  // { urls, fields }.
   URLPatterns patterns;
+  std::vector<std::string> field_names;
+  uint32_t fields = AtomNetworkDelegate::kFieldAll;
   mate::Dictionary dict;
-  args->GetNext(&dict) && dict.Get("urls", &patterns);
+  if (args->GetNext(&dict)) {
+    dict.Get("urls", &patterns);
+    if (dict.Get("fields", &field_names)) {
+      fields = 0;
+      for (const auto& name : field_names) {
+        uint32_t field = AtomNetworkDelegate::DetailsFieldFromString(name);
+        if (!field) {
+          args->ThrowError("Unknown details field: " + name);
+          return;
+        }
+        fields |= field;
+      }
+    }
+  }
 
   // Function or null.
   v8::Local<v8::Value> value;
@@ -191,7 +247,7 @@ void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
         base::Unretained(this),
         scoped_refptr<net::URLRequestContextGetter>(
           profile_->GetRequestContext()),
-          method, type, patterns, listener));
+          method, type, patterns, fields, listener));
 }
 
 void WebRequest::HandleBehaviorChanged() {
@@ -238,6 +294,8 @@ void WebRequest::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("onErrorOccurred",
                  &WebRequest::SetSimpleListener<
                     AtomNetworkDelegate::kOnErrorOccurred>)
+      .SetMethod("setRules",
+                 &WebRequest::SetRules)
       .SetMethod("handleBehaviorChanged",
                  &WebRequest::HandleBehaviorChanged)
       .SetMethod("fetch",
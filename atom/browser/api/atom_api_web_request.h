@@ -52,6 +52,7 @@ class WebRequest : public mate::TrackableObject<WebRequest>,
       v8::Local<v8::String>)> FetchCallback;
   void HandleBehaviorChanged();
   void Fetch(mate::Arguments* args);
+  void SetRules(mate::Arguments* args);
   void OnURLFetchComplete(const net::URLFetcher* source) override;
 
   // C++ can not distinguish overloaded member function.
@@ -63,7 +64,7 @@ class WebRequest : public mate::TrackableObject<WebRequest>,
   void SetListenerOnIOThread(
       const scoped_refptr<net::URLRequestContextGetter>& request_context,
       Method method, Event type,
-      URLPatterns patterns, Listener listener);
+      URLPatterns patterns, uint32_t fields, Listener listener);
   template<typename Listener, typename Method, typename Event>
   void SetListener(Method method, Event type, mate::Arguments* args);
 
@@ -5,8 +5,9 @@
 #include "atom/browser/api/event.h"
 
 #include "atom/common/api/api_messages.h"
-#include "atom/common/native_mate_converters/string16_converter.h"
+#include "brave/common/serialized_args.h"
 #include "content/public/browser/web_contents.h"
+#include "native_mate/arguments.h"
 #include "native_mate/object_template_builder.h"
 
 namespace mate {
@@ -40,17 +41,32 @@ void Event::PreventDefault(v8::Isolate* isolate) {
                            v8::True(isolate));
 }
 
-bool Event::SendReply(const base::string16& json) {
+bool Event::SendReply(mate::Arguments* args, v8::Local<v8::Value> value) {
   if (message_ == nullptr || sender_ == nullptr)
     return false;
 
-  AtomViewHostMsg_Message_Sync::WriteReplyParams(message_, json);
+  AtomMsg_SerializedArgs result;
+  if (!brave::SerializeArgs(args->isolate(), value, &result)) {
+    args->ThrowError("An object could not be cloned");
+    return false;
+  }
+
+  // Both kinds of sync messages have the same reply parameters.
+  AtomViewHostMsg_Message_Sync::WriteReplyParams(message_, result);
   bool success = sender_->Send(message_);
   message_ = nullptr;
   sender_ = nullptr;
   return success;
 }
 
+// static
+void Event::SendEmptyReply(content::WebContents* sender,
+                           IPC::Message* message) {
+  AtomViewHostMsg_Message_Sync::WriteReplyParams(message,
+                                                 AtomMsg_SerializedArgs());
+  sender->Send(message);
+}
+
 // static
 Handle<Event> Event::Create(v8::Isolate* isolate) {
   return mate::CreateHandle(isolate, new Event(isolate));
@@ -15,6 +15,8 @@ class Message;
 
 namespace mate {
 
+class Arguments;
+
 class Event : public Wrappable<Event>,
               public content::WebContentsObserver {
  public:
@@ -29,8 +31,14 @@ class Event : public Wrappable<Event>,
   // event.PreventDefault().
   void PreventDefault(v8::Isolate* isolate);
 
-  // event.sendReply(json), used for replying synchronous message.
-  bool SendReply(const base::string16& json);
+  // event.sendReply(value), used for replying synchronous message. Throws if
+  // |value| can not be cloned.
+  bool SendReply(mate::Arguments* args, v8::Local<v8::Value> value);
+
+  // Replies to a synchronous message that could not be dispatched, so the
+  // renderer does not wait forever.
+  static void SendEmptyReply(content::WebContents* sender,
+                             IPC::Message* message);
 
  protected:
   explicit Event(v8::Isolate* isolate);
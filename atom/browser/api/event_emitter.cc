@@ -5,6 +5,8 @@
 #include "atom/browser/api/event_emitter.h"
 
 #include "atom/browser/api/event.h"
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
 #include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
@@ -18,6 +20,18 @@ namespace {
 
 v8::Persistent<v8::ObjectTemplate> event_template;
 
+// IPC channels are emitted as events too, so a renderer could otherwise grow
+// the counters without bound.
+const size_t kMaxCountedEvents = 1024;
+
+struct EmitCountsRegistry {
+  base::Lock lock;
+  std::map<std::string, EmitCounts> counts;
+};
+
+base::LazyInstance<EmitCountsRegistry>::Leaky g_emit_counts =
+    LAZY_INSTANCE_INITIALIZER;
+
 void PreventDefault(mate::Arguments* args) {
   mate::Dictionary self(args->isolate(), args->GetThis());
   self.Set("defaultPrevented", true);
@@ -77,6 +91,53 @@ v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags) {
   return obj.GetHandle();
 }
 
+bool HasListeners(v8::Isolate* isolate,
+                  v8::Local<v8::Object> object,
+                  const base::StringPiece& name) {
+  // Node throws for an "error" event without listeners.
+  if (name == "error")
+    return true;
+
+  // Node's EventEmitter keeps a function, or an array of them, under the
+  // event name in |_events| and deletes the entry with the last listener,
+  // so looking it up is cheaper than calling listenerCount().
+  v8::Local<v8::Context> context = object->CreationContext();
+  v8::Local<v8::Value> events;
+  if (!object->Get(context, StringToSymbol(isolate, "_events"))
+          .ToLocal(&events))
+    return true;
+  if (!events->IsObject())
+    return false;
+
+  v8::Local<v8::Value> listeners;
+  if (!events.As<v8::Object>()->Get(context, StringToV8(isolate, name))
+          .ToLocal(&listeners))
+    return true;
+  return listeners->IsFunction() || listeners->IsArray();
+}
+
+void RecordEmit(const base::StringPiece& name, bool emitted) {
+  EmitCountsRegistry* registry = g_emit_counts.Pointer();
+  base::AutoLock auto_lock(registry->lock);
+  auto it = registry->counts.find(name.as_string());
+  if (it == registry->counts.end()) {
+    if (registry->counts.size() == kMaxCountedEvents)
+      return;
+    it = registry->counts.insert(
+        std::make_pair(name.as_string(), EmitCounts())).first;
+  }
+  if (emitted)
+    ++it->second.emitted;
+  else
+    ++it->second.skipped;
+}
+
 }  // namespace internal
 
+std::map<std::string, EmitCounts> GetEmitCounts() {
+  EmitCountsRegistry* registry = g_emit_counts.Pointer();
+  base::AutoLock auto_lock(registry->lock);
+  return registry->counts;
+}
+
 }  // namespace mate
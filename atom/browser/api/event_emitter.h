@@ -5,6 +5,10 @@
 #ifndef ATOM_BROWSER_API_EVENT_EMITTER_H_
 #define ATOM_BROWSER_API_EVENT_EMITTER_H_
 
+#include <stdint.h>
+
+#include <map>
+#include <string>
 #include <vector>
 
 #include "atom/common/api/event_emitter_caller.h"
@@ -20,6 +24,15 @@ class Message;
 
 namespace mate {
 
+// How often each event name was emitted, and how often it was not because
+// there was no listener for it.
+struct EmitCounts {
+  uint64_t emitted = 0;
+  uint64_t skipped = 0;
+};
+
+std::map<std::string, EmitCounts> GetEmitCounts();
+
 namespace internal {
 
 v8::Local<v8::Object> CreateJSEvent(v8::Isolate* isolate,
@@ -32,6 +45,12 @@ v8::Local<v8::Object> CreateCustomEvent(
     v8::Local<v8::Object> event);
 v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags);
 
+// Whether the node EventEmitter |object| has a listener for |name|.
+bool HasListeners(v8::Isolate* isolate,
+                  v8::Local<v8::Object> object,
+                  const base::StringPiece& name);
+void RecordEmit(const base::StringPiece& name, bool emitted);
+
 }  // namespace internal
 
 // Provide helperers to emit event in JavaScript.
@@ -45,11 +64,24 @@ class EventEmitter : public Wrappable<T> {
   v8::Local<v8::Object> GetWrapper() { return Wrappable<T>::GetWrapper(); }
   v8::Isolate* isolate() const { return Wrappable<T>::isolate(); }
 
+  // this.listenerCount(name) > 0, without calling into JavaScript.
+  bool HasListeners(const base::StringPiece& name) {
+    v8::Locker locker(isolate());
+    v8::HandleScope handle_scope(isolate());
+    v8::Local<v8::Object> wrapper = GetWrapper();
+    return !wrapper.IsEmpty() &&
+           internal::HasListeners(isolate(), wrapper, name);
+  }
+
   // this.emit(name, event, args...);
   template<typename... Args>
   bool EmitCustomEvent(const base::StringPiece& name,
                        v8::Local<v8::Object> event,
                        const Args&... args) {
+    if (!HasListeners(name)) {
+      internal::RecordEmit(name, false);
+      return false;
+    }
     return EmitWithEvent(
         name,
         internal::CreateCustomEvent(isolate(), GetWrapper(), event), args...);
@@ -82,6 +114,12 @@ class EventEmitter : public Wrappable<T> {
     v8::Local<v8::Object> wrapper = GetWrapper();
     if (wrapper.IsEmpty())
       return false;
+    // Nothing is converted when nobody listens, except for synchronous
+    // messages which JavaScript has to reply to.
+    if (!message && !internal::HasListeners(isolate(), wrapper, name)) {
+      internal::RecordEmit(name, false);
+      return false;
+    }
     v8::Local<v8::Object> event = internal::CreateJSEvent(
         isolate(), wrapper, sender, message);
     return EmitWithEvent(name, event, args...);
@@ -90,6 +128,9 @@ class EventEmitter : public Wrappable<T> {
  protected:
   EventEmitter() {}
 
+  // Called right before any event is emitted to JavaScript.
+  virtual void WillEmit() {}
+
  private:
   // this.emit(name, event, args...);
   template<typename... Args>
@@ -98,6 +139,8 @@ class EventEmitter : public Wrappable<T> {
                      const Args&... args) {
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
+    WillEmit();
+    internal::RecordEmit(name, true);
     EmitEvent(isolate(), GetWrapper(), name, event, args...);
     return event->Get(
         StringToV8(isolate(), "defaultPrevented"))->BooleanValue();
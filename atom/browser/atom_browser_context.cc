@@ -55,6 +55,27 @@ class NoCacheBackend : public net::HttpCache::BackendFactory {
   }
 };
 
+// Builds the network session shared between partitions with the same
+// certificate verifier and SSL config as a partition of its own, so that
+// setCertificateVerifyProc keeps working on sessions that share it.
+class SharedNetworkSessionDelegate
+    : public brightray::URLRequestContextGetter::Delegate {
+ public:
+  SharedNetworkSessionDelegate() {}
+
+  // brightray::URLRequestContextGetter::Delegate:
+  std::unique_ptr<net::CertVerifier> CreateCertVerifier() override {
+    return base::WrapUnique(new AtomCertVerifier);
+  }
+
+  net::SSLConfigService* CreateSSLConfigService() override {
+    return new AtomSSLConfigService;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SharedNetworkSessionDelegate);
+};
+
 }  // namespace
 
 AtomBrowserContext::AtomBrowserContext(
@@ -65,6 +86,10 @@ AtomBrowserContext::AtomBrowserContext(
   // Read options.
   use_cache_ = true;
   options.GetBoolean("cache", &use_cache_);
+  share_network_session_ = false;
+  options.GetBoolean("shared_network_session", &share_network_session_);
+  enable_quic_ = false;
+  options.GetBoolean("quic", &enable_quic_);
 
   // Initialize Pref Registry in brightray.
   // InitPrefs();
@@ -159,6 +184,19 @@ std::vector<std::string> AtomBrowserContext::GetCookieableSchemes() {
   return default_schemes;
 }
 
+bool AtomBrowserContext::ShouldShareNetworkSession() {
+  return share_network_session_;
+}
+
+std::unique_ptr<brightray::URLRequestContextGetter::Delegate>
+AtomBrowserContext::CreateSharedNetworkSessionDelegate() {
+  return base::MakeUnique<SharedNetworkSessionDelegate>();
+}
+
+bool AtomBrowserContext::ShouldEnableQuic() {
+  return enable_quic_;
+}
+
 void AtomBrowserContext::RegisterPrefs(PrefRegistrySimple* pref_registry) {
   pref_registry->RegisterFilePathPref(prefs::kSelectFileLastDirectory,
                                       base::FilePath());
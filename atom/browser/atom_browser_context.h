@@ -35,6 +35,10 @@ class AtomBrowserContext : public brightray::BrowserContext {
   std::unique_ptr<net::CertVerifier> CreateCertVerifier() override;
   net::SSLConfigService* CreateSSLConfigService() override;
   std::vector<std::string> GetCookieableSchemes() override;
+  bool ShouldShareNetworkSession() override;
+  std::unique_ptr<brightray::URLRequestContextGetter::Delegate>
+      CreateSharedNetworkSessionDelegate() override;
+  bool ShouldEnableQuic() override;
 
   // content::BrowserContext:
   content::DownloadManagerDelegate* GetDownloadManagerDelegate() override;
@@ -55,6 +59,8 @@ class AtomBrowserContext : public brightray::BrowserContext {
   std::unique_ptr<AtomDownloadManagerDelegate> download_manager_delegate_;
   std::unique_ptr<AtomPermissionManager> permission_manager_;
   bool use_cache_;
+  bool share_network_session_;
+  bool enable_quic_;
 
   // Managed by brightray::BrowserContext.
   AtomNetworkDelegate* network_delegate_;
@@ -22,6 +22,7 @@
 #include "base/memory/memory_pressure_monitor.h"
 #include "base/path_service.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "brave/common/extensions/module_code_cache.h"
 #include "brightray/browser/brightray_paths.h"
 #include "browser/media/media_capture_devices_dispatcher.h"
 #include "chrome/browser/browser_process_impl.h"
@@ -200,8 +201,13 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
 
   // Make sure the userData directory is created.
   base::FilePath user_data;
-  if (PathService::Get(brightray::DIR_USER_DATA, &user_data))
+  if (PathService::Get(brightray::DIR_USER_DATA, &user_data)) {
     base::CreateDirectoryAndGetError(user_data, nullptr);
+    // The app can only have changed userData by now, so modules loaded so far
+    // are written there too.
+    brave::ModuleCodeCache::GetInstance()->SetDirectory(
+        user_data.Append(FILE_PATH_LITERAL("Module Code Cache")));
+  }
 
   // PreProfileInit
   EnsureBrowserContextKeyedServiceFactoriesBuilt();
@@ -5,12 +5,16 @@
 #include "atom/browser/extensions/atom_browser_client_extensions_part.h"
 
 #include <map>
+#include <memory>
 #include <set>
+#include <utility>
 
 #include "atom/common/api/api_messages.h"
+#include "atom/common/content_settings_delta.h"
 #include "base/command_line.h"
 #include "brave/browser/api/brave_api_extension.h"
 #include "chrome/browser/browser_process.h"
+#include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/renderer_host/chrome_extension_message_filter.h"
@@ -21,8 +25,10 @@
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 #include "components/user_prefs/user_prefs.h"
+#include "content/public/browser/browser_message_filter.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/browser_url_handler.h"
+#include "content/public/browser/notification_service.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/site_instance.h"
@@ -91,6 +97,65 @@ RenderProcessHostPrivilege GetProcessPrivilege(
 
 static std::map<int, void*> render_process_hosts_;
 
+// The content settings last sent to the renderers of one PrefService.
+struct ContentSettingsState {
+  int version = 0;
+  std::unique_ptr<base::DictionaryValue> settings;
+  // Splices from |base_version| to |version|, null if only a full update can
+  // bring renderers at |base_version| up to date.
+  int base_version = 0;
+  std::unique_ptr<base::ListValue> delta;
+};
+
+static std::map<PrefService*, ContentSettingsState> content_settings_states_;
+
+// Versions are shared by all PrefServices, so a renderer can never hold a
+// version of other settings that happens to match.
+static int last_content_settings_version_ = 0;
+
+// The content settings version each render process host was last sent.
+static std::map<int, int> content_settings_versions_;
+
+// Handles the requests of renderers that could not apply a delta.
+class ContentSettingsMessageFilter : public content::BrowserMessageFilter {
+ public:
+  ContentSettingsMessageFilter(AtomBrowserClientExtensionsPart* part,
+                               int render_process_id)
+      : content::BrowserMessageFilter(ShellMsgStart),
+        part_(part),
+        render_process_id_(render_process_id) {}
+
+  // content::BrowserMessageFilter:
+  void OverrideThreadForMessage(const IPC::Message& message,
+                                BrowserThread::ID* thread) override {
+    if (message.type() == AtomHostMsg_RequestContentSettings::ID)
+      *thread = BrowserThread::UI;
+  }
+
+  bool OnMessageReceived(const IPC::Message& message) override {
+    bool handled = true;
+    IPC_BEGIN_MESSAGE_MAP(ContentSettingsMessageFilter, message)
+      IPC_MESSAGE_HANDLER(AtomHostMsg_RequestContentSettings,
+                          OnRequestContentSettings)
+      IPC_MESSAGE_UNHANDLED(handled = false)
+    IPC_END_MESSAGE_MAP()
+    return handled;
+  }
+
+ private:
+  ~ContentSettingsMessageFilter() override {}
+
+  void OnRequestContentSettings() {
+    part_->ResendContentSettings(render_process_id_);
+  }
+
+  // Owned by the browser client, which outlives the render process hosts.
+  AtomBrowserClientExtensionsPart* part_;
+  const int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsMessageFilter);
+};
+
 }  // namespace
 
 AtomBrowserClientExtensionsPart::AtomBrowserClientExtensionsPart() {
@@ -326,14 +391,42 @@ void AtomBrowserClientExtensionsPart::RenderProcessWillLaunch(
        id, context, host->GetStoragePartition()->GetServiceWorkerContext()));
   }
 
+  host->AddFilter(new ContentSettingsMessageFilter(this, id));
+
+  // The notification service does not exist yet when the browser client is
+  // created.
+  if (!registrar_.IsRegistered(this, chrome::NOTIFICATION_PROFILE_DESTROYED,
+                               content::NotificationService::AllSources())) {
+    registrar_.Add(this, chrome::NOTIFICATION_PROFILE_DESTROYED,
+                   content::NotificationService::AllSources());
+  }
+
   auto user_prefs_registrar = context->user_prefs_change_registrar();
   if (!user_prefs_registrar->IsObserved("content_settings")) {
     user_prefs_registrar->Add(
         "content_settings",
         base::Bind(&AtomBrowserClientExtensionsPart::UpdateContentSettings,
-                   base::Unretained(this)));
+                   base::Unretained(this),
+                   user_prefs::UserPrefs::Get(context)));
   }
-  UpdateContentSettingsForHost(host->GetID());
+  // A relaunched process starts without any content settings.
+  ResendContentSettings(id);
+}
+
+void AtomBrowserClientExtensionsPart::ResendContentSettings(
+    int render_process_id) {
+  content_settings_versions_.erase(render_process_id);
+  UpdateContentSettingsForHost(render_process_id);
+}
+
+void AtomBrowserClientExtensionsPart::Observe(
+    int type,
+    const content::NotificationSource& source,
+    const content::NotificationDetails& details) {
+  DCHECK_EQ(chrome::NOTIFICATION_PROFILE_DESTROYED, type);
+  // Another PrefService can be allocated at the same address later.
+  Profile* profile = content::Source<Profile>(source).ptr();
+  content_settings_states_.erase(user_prefs::UserPrefs::Get(profile));
 }
 
 // static
@@ -364,18 +457,58 @@ GURL AtomBrowserClientExtensionsPart::GetEffectiveURL(
 void AtomBrowserClientExtensionsPart::UpdateContentSettingsForHost(
   int render_process_id) {
   auto host = content::RenderProcessHost::FromID(render_process_id);
-  if (!host)
+  if (!host) {
+    content_settings_versions_.erase(render_process_id);
     return;
+  }
 
-  auto context =
-      static_cast<atom::AtomBrowserContext*>(host->GetBrowserContext());
-  auto user_prefs = user_prefs::UserPrefs::Get(context);
-  const base::DictionaryValue* content_settings =
-    user_prefs->GetDictionary("content_settings");
-  host->Send(new AtomMsg_UpdateContentSettings(*content_settings));
+  auto user_prefs = user_prefs::UserPrefs::Get(host->GetBrowserContext());
+  ContentSettingsState& state = content_settings_states_[user_prefs];
+  if (!state.settings) {
+    state.version = ++last_content_settings_version_;
+    state.settings =
+        user_prefs->GetDictionary("content_settings")->CreateDeepCopy();
+  }
+
+  // Renderers at the base of the last delta only need the delta, everything
+  // else gets the full settings.
+  auto it = content_settings_versions_.find(render_process_id);
+  if (it != content_settings_versions_.end()) {
+    if (it->second == state.version)
+      return;
+    if (state.delta && it->second == state.base_version) {
+      host->Send(new AtomMsg_UpdateContentSettingsDelta(
+          it->second, state.version, *state.delta));
+      it->second = state.version;
+      return;
+    }
+  }
+
+  host->Send(new AtomMsg_UpdateContentSettings(state.version,
+                                               *state.settings));
+  content_settings_versions_[render_process_id] = state.version;
 }
 
-void AtomBrowserClientExtensionsPart::UpdateContentSettings() {
+void AtomBrowserClientExtensionsPart::UpdateContentSettings(
+    PrefService* user_prefs) {
+  const base::DictionaryValue* settings =
+      user_prefs->GetDictionary("content_settings");
+  ContentSettingsState& state = content_settings_states_[user_prefs];
+
+  std::unique_ptr<base::ListValue> delta;
+  if (state.settings) {
+    delta.reset(new base::ListValue);
+    if (!DiffContentSettings(*state.settings, *settings, delta.get()))
+      delta.reset();
+    else if (delta->empty())
+      return;
+  }
+
+  state.base_version = state.version;
+  state.version = ++last_content_settings_version_;
+  state.settings = settings->CreateDeepCopy();
+  state.delta = std::move(delta);
+
   for (std::map<int, void*>::iterator
       it = render_process_hosts_.begin();
       it != render_process_hosts_.end();
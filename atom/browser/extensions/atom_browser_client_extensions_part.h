@@ -9,6 +9,8 @@
 #include <vector>
 #include "base/compiler_specific.h"
 #include "base/macros.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
 
 class GURL;
 class PrefRegistrySimple;
@@ -33,10 +35,10 @@ class Profile;
 namespace extensions {
 
 // Implements the extensions portion of AtomBrowserClient.
-class AtomBrowserClientExtensionsPart {
+class AtomBrowserClientExtensionsPart : public content::NotificationObserver {
  public:
   AtomBrowserClientExtensionsPart();
-  ~AtomBrowserClientExtensionsPart();
+  ~AtomBrowserClientExtensionsPart() override;
 
   // Corresponds to the AtomBrowserClient function of the same name.
   static GURL GetEffectiveURL(Profile* profile, const GURL& url);
@@ -85,10 +87,23 @@ class AtomBrowserClientExtensionsPart {
       content::BrowserContext* browser_context);
   std::string GetApplicationLocale();
 
+  // Sends the full content settings to a renderer, which it asks for when it
+  // cannot apply a delta.
+  void ResendContentSettings(int render_process_id);
+
  private:
-  void UpdateContentSettings();
+  // content::NotificationObserver:
+  void Observe(int type,
+               const content::NotificationSource& source,
+               const content::NotificationDetails& details) override;
+
+  // Sends the changes to the content settings of |user_prefs| to the
+  // renderers using them.
+  void UpdateContentSettings(PrefService* user_prefs);
+  // Brings the content settings of a renderer up to date.
   void UpdateContentSettingsForHost(int render_process_id);
 
+  content::NotificationRegistrar registrar_;
 
   DISALLOW_COPY_AND_ASSIGN(AtomBrowserClientExtensionsPart);
 };
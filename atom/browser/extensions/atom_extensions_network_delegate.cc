@@ -49,8 +49,8 @@ void AtomExtensionsNetworkDelegate::RunCallback(
     int result = internal_callback.Run();
 
     if (result != net::ERR_IO_PENDING) {
-      // nothing ran the original callback
-      callbacks_[request_id].Run(net::OK);
+      // nothing ran the original callback, e.g. a rule decided the request
+      callbacks_[request_id].Run(result);
     }
   } else {
     // nothing ran the original callback
@@ -16,6 +16,7 @@
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "net/base/file_stream.h"
 #include "net/base/filename_util.h"
 #include "net/base/io_buffer.h"
@@ -66,6 +67,16 @@ void Initialize(
   *type = URLRequestAsarJob::TYPE_ASAR;
 }
 
+// Touching the mapping can page in from disk, so the copy runs on the file
+// task runner. |archive| keeps the mapping alive until it is done.
+int CopyFromMapping(std::shared_ptr<Archive> archive,
+                    const char* data,
+                    scoped_refptr<net::IOBuffer> buf,
+                    int size) {
+  memcpy(buf->data(), data, size);
+  return size;
+}
+
 }  // namespace
 
 URLRequestAsarJob::FileMetaInfo::FileMetaInfo()
@@ -81,6 +92,8 @@ URLRequestAsarJob::URLRequestAsarJob(
     const scoped_refptr<base::TaskRunner> file_task_runner)
     : net::URLRequestJob(request, network_delegate),
       type_(TYPE_ERROR),
+      read_from_mapping_(false),
+      mapped_position_(0),
       remaining_bytes_(0),
       seek_offset_(0),
       range_parse_result_(net::OK),
@@ -109,7 +122,12 @@ void URLRequestAsarJob::Start() {
 }
 
 void URLRequestAsarJob::DidInitialize() {
-  if (type_ == TYPE_ASAR) {
+  if (type_ == TYPE_ASAR &&
+      archive_->GetMappedData(file_info_.offset, file_info_.stored_size(),
+                              &mapped_data_)) {
+    read_from_mapping_ = true;
+    DidOpen(net::OK);
+  } else if (type_ == TYPE_ASAR) {
     InitializeAsarJob();
     int flags = base::File::FLAG_OPEN |
                 base::File::FLAG_READ |
@@ -151,6 +169,18 @@ int URLRequestAsarJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
   if (!dest_size)
     return 0;
 
+  if (read_from_mapping_) {
+    const char* data = mapped_data_.data() + mapped_position_;
+    mapped_position_ += dest_size;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::Bind(&CopyFromMapping, archive_, data, base::RetainedRef(dest),
+                   dest_size),
+        base::Bind(&URLRequestAsarJob::DidRead,
+                   weak_ptr_factory_.GetWeakPtr(), base::RetainedRef(dest)));
+    return net::ERR_IO_PENDING;
+  }
+
   int rv = stream_->Read(dest,
                          dest_size,
                          base::Bind(&URLRequestAsarJob::DidRead,
@@ -193,6 +223,12 @@ bool URLRequestAsarJob::IsRedirectResponse(GURL* location,
 std::unique_ptr<net::SourceStream> URLRequestAsarJob::SetUpSourceStream() {
   std::unique_ptr<net::SourceStream> source =
     URLRequestJob::SetUpSourceStream();
+
+  // Compressed entries are expanded as they are read.
+  if (type_ == TYPE_ASAR && file_info_.compressed)
+    source = net::GzipSourceStream::Create(std::move(source),
+                                           net::SourceStream::TYPE_GZIP);
+
   if (!base::LowerCaseEqualsASCII(file_path_.Extension(), ".svgz"))
     return source;
 
@@ -290,7 +326,14 @@ void URLRequestAsarJob::DidOpen(int result) {
 
   int64_t file_size, read_offset;
   if (type_ == TYPE_ASAR) {
-    file_size = file_info_.size;
+    // A gzip stream can not be entered in the middle.
+    if (file_info_.compressed && byte_range_.IsValid()) {
+      NotifyStartError(
+          net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+      return;
+    }
+    file_size = file_info_.stored_size();
     read_offset = file_info_.offset;
   } else {
     file_size = meta_info_.file_size;
@@ -308,6 +351,12 @@ void URLRequestAsarJob::DidOpen(int result) {
                      byte_range_.first_byte_position() + 1;
   seek_offset_ = byte_range_.first_byte_position() + read_offset;
 
+  if (read_from_mapping_) {
+    mapped_position_ = byte_range_.first_byte_position();
+    DidSeek(seek_offset_);
+    return;
+  }
+
   if (remaining_bytes_ > 0 && seek_offset_ != 0) {
     int rv = stream_->Seek(seek_offset_,
                            base::Bind(&URLRequestAsarJob::DidSeek,
@@ -332,7 +381,10 @@ void URLRequestAsarJob::DidSeek(int64_t result) {
                               net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
     return;
   }
-  set_expected_content_size(remaining_bytes_);
+  if (type_ == TYPE_ASAR && file_info_.compressed)
+    set_expected_content_size(file_info_.size);
+  else
+    set_expected_content_size(remaining_bytes_);
   NotifyHeadersComplete();
 }
 
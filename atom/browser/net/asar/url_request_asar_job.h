@@ -13,6 +13,7 @@
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 #include "net/http/http_byte_range.h"
 #include "net/url_request/url_request_job.h"
 
@@ -112,6 +113,12 @@ class URLRequestAsarJob : public net::URLRequestJob {
   std::unique_ptr<net::FileStream> stream_;
   FileMetaInfo meta_info_;
 
+  // Packed files of a mapped archive are copied out of the mapping on the
+  // file task runner instead of going through |stream_|.
+  base::StringPiece mapped_data_;
+  bool read_from_mapping_;
+  int64_t mapped_position_;
+
   net::HttpByteRange byte_range_;
   int64_t remaining_bytes_;
   int64_t seek_offset_;
@@ -7,6 +7,7 @@
 #include <memory>
 #include <utility>
 
+#include "atom/browser/net/web_request_rules.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
@@ -14,6 +15,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/websocket_handshake_request_info.h"
 #include "extensions/features/features.h"
+#include "net/http/http_response_info.h"
 #include "net/url_request/url_request.h"
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
@@ -74,15 +76,8 @@ void RunResponseListener(
 
 // Test whether the URL of |request| matches |patterns|.
 bool MatchesFilterCondition(net::URLRequest* request,
-                            const URLPatterns& patterns) {
-  if (patterns.empty())
-    return true;
-
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(request->url()))
-      return true;
-  }
-  return false;
+                            const URLPatternMatcher& patterns) {
+  return patterns.MatchesURL(request->url());
 }
 
 int GetTabId(net::URLRequest* request) {
@@ -115,22 +110,47 @@ int GetTabId(net::URLRequest* request) {
 #endif
 }
 
-// Overloaded by multiple types to fill the |details| object.
-void ToDictionary(base::DictionaryValue* details, net::URLRequest* request) {
-  FillRequestDetails(details, request);
-  details->SetInteger("id", request->identifier());
-  details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
-  details->SetString("firstPartyUrl",
-    request->first_party_for_cookies().spec());
-  auto info = content::ResourceRequestInfo::ForRequest(request);
-  details->SetString("resourceType",
-                     info ? ResourceTypeToString(info->GetResourceType())
-                          : "other");
-  details->SetInteger("tabId", GetTabId(request));
+// Overloaded by multiple types to fill the |details| object with the
+// |fields| the listener asked for.
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
+                  net::URLRequest* request) {
+  if (fields & AtomNetworkDelegate::kFieldMethod)
+    details->SetString("method", request->method());
+  if (fields & AtomNetworkDelegate::kFieldUrl) {
+    std::string url;
+    if (!request->url_chain().empty()) url = request->url().spec();
+    details->SetStringWithoutPathExpansion("url", url);
+  }
+  if (fields & AtomNetworkDelegate::kFieldReferrer)
+    details->SetString("referrer", request->referrer());
+  if (fields & AtomNetworkDelegate::kFieldUploadData) {
+    std::unique_ptr<base::ListValue> list(new base::ListValue);
+    GetUploadData(list.get(), request);
+    if (!list->empty())
+      details->Set("uploadData", std::move(list));
+  }
+  if (fields & AtomNetworkDelegate::kFieldId)
+    details->SetInteger("id", request->identifier());
+  if (fields & AtomNetworkDelegate::kFieldTimestamp)
+    details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
+  if (fields & AtomNetworkDelegate::kFieldFirstPartyUrl)
+    details->SetString("firstPartyUrl",
+      request->first_party_for_cookies().spec());
+  if (fields & AtomNetworkDelegate::kFieldResourceType) {
+    auto info = content::ResourceRequestInfo::ForRequest(request);
+    details->SetString("resourceType",
+                       info ? ResourceTypeToString(info->GetResourceType())
+                            : "other");
+  }
+  if (fields & AtomNetworkDelegate::kFieldTabId)
+    details->SetInteger("tabId", GetTabId(request));
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
                   const net::HttpRequestHeaders& headers) {
+  if (!(fields & AtomNetworkDelegate::kFieldRequestHeaders))
+    return;
+
   std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
   net::HttpRequestHeaders::Iterator it(headers);
   while (it.GetNext())
@@ -138,60 +158,82 @@ void ToDictionary(base::DictionaryValue* details,
   details->Set("requestHeaders", std::move(dict));
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
                   const net::HttpResponseHeaders* headers) {
   if (!headers)
     return;
 
-  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
-  size_t iter = 0;
-  std::string key;
-  std::string value;
-  while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
-    if (dict->HasKey(key)) {
-      base::ListValue* values = nullptr;
-      if (dict->GetList(key, &values))
+  if (fields & AtomNetworkDelegate::kFieldResponseHeaders) {
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    size_t iter = 0;
+    std::string key;
+    std::string value;
+    while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
+      if (dict->HasKey(key)) {
+        base::ListValue* values = nullptr;
+        if (dict->GetList(key, &values))
+          values->AppendString(value);
+      } else {
+        std::unique_ptr<base::ListValue> values(new base::ListValue);
         values->AppendString(value);
-    } else {
-      std::unique_ptr<base::ListValue> values(new base::ListValue);
-      values->AppendString(value);
-      dict->Set(key, std::move(values));
+        dict->Set(key, std::move(values));
+      }
     }
+    details->Set("responseHeaders", std::move(dict));
+  }
+  if (fields & AtomNetworkDelegate::kFieldStatus) {
+    details->SetString("statusLine", headers->GetStatusLine());
+    details->SetInteger("statusCode", headers->response_code());
   }
-  details->Set("responseHeaders", std::move(dict));
-  details->SetString("statusLine", headers->GetStatusLine());
-  details->SetInteger("statusCode", headers->response_code());
 }
 
-void ToDictionary(base::DictionaryValue* details, const GURL& location) {
-  details->SetString("redirectURL", location.spec());
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
+                  const GURL& location) {
+  if (fields & AtomNetworkDelegate::kFieldRedirectUrl)
+    details->SetString("redirectURL", location.spec());
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
                   const net::HostPortPair& host_port) {
-  if (host_port.host().empty())
+  if ((fields & AtomNetworkDelegate::kFieldIp) && host_port.host().empty())
     details->SetString("ip", host_port.host());
 }
 
-void ToDictionary(base::DictionaryValue* details, bool from_cache) {
-  details->SetBoolean("fromCache", from_cache);
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
+                  bool from_cache) {
+  if (fields & AtomNetworkDelegate::kFieldFromCache)
+    details->SetBoolean("fromCache", from_cache);
+}
+
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
+                  net::HttpResponseInfo::ConnectionInfo connection_info) {
+  // Internal redirects and non-HTTP jobs have no connection.
+  if ((fields & AtomNetworkDelegate::kFieldProtocol) &&
+      connection_info != net::HttpResponseInfo::CONNECTION_INFO_UNKNOWN) {
+    details->SetString(
+        "protocol",
+        net::HttpResponseInfo::ConnectionInfoToString(connection_info));
+  }
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(base::DictionaryValue* details, uint32_t fields,
                   const net::URLRequestStatus& status) {
-  details->SetString("error", net::ErrorToString(status.error()));
+  if (fields & AtomNetworkDelegate::kFieldError)
+    details->SetString("error", net::ErrorToString(status.error()));
 }
 
 // Helper function to fill |details| with arbitrary |args|.
 template<typename Arg>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg) {
-  ToDictionary(details, arg);
+void FillDetailsObject(base::DictionaryValue* details, uint32_t fields,
+                       Arg arg) {
+  ToDictionary(details, fields, arg);
 }
 
 template<typename Arg, typename... Args>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg, Args... args) {
-  ToDictionary(details, arg);
-  FillDetailsObject(details, args...);
+void FillDetailsObject(base::DictionaryValue* details, uint32_t fields,
+                       Arg arg, Args... args) {
+  ToDictionary(details, fields, arg);
+  FillDetailsObject(details, fields, args...);
 }
 
 // Fill the native types with the result from the response object.
@@ -254,24 +296,65 @@ AtomNetworkDelegate::AtomNetworkDelegate() {
 AtomNetworkDelegate::~AtomNetworkDelegate() {
 }
 
+// static
+uint32_t AtomNetworkDelegate::DetailsFieldFromString(const std::string& name) {
+  static const struct {
+    const char* name;
+    uint32_t field;
+  } kFields[] = {
+    { "id", kFieldId },
+    { "url", kFieldUrl },
+    { "method", kFieldMethod },
+    { "referrer", kFieldReferrer },
+    { "uploadData", kFieldUploadData },
+    { "timestamp", kFieldTimestamp },
+    { "firstPartyUrl", kFieldFirstPartyUrl },
+    { "resourceType", kFieldResourceType },
+    { "tabId", kFieldTabId },
+    { "requestHeaders", kFieldRequestHeaders },
+    { "responseHeaders", kFieldResponseHeaders },
+    { "statusLine", kFieldStatus },
+    { "statusCode", kFieldStatus },
+    { "redirectURL", kFieldRedirectUrl },
+    { "ip", kFieldIp },
+    { "fromCache", kFieldFromCache },
+    { "error", kFieldError },
+    { "protocol", kFieldProtocol },
+  };
+  for (const auto& field : kFields) {
+    if (name == field.name)
+      return field.field;
+  }
+  return 0;
+}
+
 void AtomNetworkDelegate::SetSimpleListenerInIO(
     SimpleEvent type,
     const URLPatterns& patterns,
+    uint32_t fields,
     const SimpleListener& callback) {
   if (callback.is_null())
     simple_listeners_.erase(type);
   else
-    simple_listeners_[type] = { patterns, callback };
+    simple_listeners_[type] =
+        { URLPatternMatcher(patterns), fields, callback };
 }
 
 void AtomNetworkDelegate::SetResponseListenerInIO(
     ResponseEvent type,
     const URLPatterns& patterns,
+    uint32_t fields,
     const ResponseListener& callback) {
   if (callback.is_null())
     response_listeners_.erase(type);
   else
-    response_listeners_[type] = { patterns, callback };
+    response_listeners_[type] =
+        { URLPatternMatcher(patterns), fields, callback };
+}
+
+void AtomNetworkDelegate::SetRulesInIO(
+    std::unique_ptr<WebRequestRules> rules) {
+  rules_ = std::move(rules);
 }
 
 void AtomNetworkDelegate::SetDevToolsNetworkEmulationClientId(
@@ -284,6 +367,10 @@ int AtomNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  int result;
+  if (rules_ && rules_->OnBeforeRequest(request, new_url, &result))
+    return result;
+
   if (!base::ContainsKey(response_listeners_, kOnBeforeRequest))
     return brightray::NetworkDelegate::OnBeforeURLRequest(
         request, callback, new_url);
@@ -305,6 +392,11 @@ int AtomNetworkDelegate::OnBeforeStartTransaction(
     headers->SetHeader(
         DevToolsNetworkTransaction::kDevToolsEmulateNetworkConditionsClientId,
         client_id);
+
+  // Header rules only edit the headers, the listeners still see the result.
+  if (rules_)
+    rules_->OnBeforeSendHeaders(request, headers);
+
   if (!base::ContainsKey(response_listeners_, kOnBeforeSendHeaders))
     return brightray::NetworkDelegate::OnBeforeStartTransaction(
         request, callback, headers);
@@ -330,6 +422,10 @@ int AtomNetworkDelegate::OnHeadersReceived(
     const net::HttpResponseHeaders* original,
     scoped_refptr<net::HttpResponseHeaders>* override,
     GURL* new_url) {
+  // Header rules only edit the headers, the listeners get the edited ones.
+  if (rules_ && rules_->OnHeadersReceived(request, original, override))
+    original = override->get();
+
   if (!base::ContainsKey(response_listeners_, kOnHeadersReceived))
     return brightray::NetworkDelegate::OnHeadersReceived(
         request, callback, original, override, new_url);
@@ -349,7 +445,8 @@ void AtomNetworkDelegate::OnBeforeRedirect(net::URLRequest* request,
 
   HandleSimpleEvent(kOnBeforeRedirect, request, new_location,
                     request->response_headers(), request->GetSocketAddress(),
-                    request->was_cached());
+                    request->was_cached(),
+                    request->response_info().connection_info);
 }
 
 void AtomNetworkDelegate::OnResponseStarted(net::URLRequest* request) {
@@ -362,7 +459,8 @@ void AtomNetworkDelegate::OnResponseStarted(net::URLRequest* request) {
     return;
 
   HandleSimpleEvent(kOnResponseStarted, request, request->response_headers(),
-                    request->was_cached());
+                    request->was_cached(),
+                    request->response_info().connection_info);
 }
 
 void AtomNetworkDelegate::OnCompleted(net::URLRequest* request, bool started) {
@@ -388,7 +486,8 @@ void AtomNetworkDelegate::OnCompleted(net::URLRequest* request, bool started) {
   }
 
   HandleSimpleEvent(kOnCompleted, request, request->response_headers(),
-                    request->was_cached());
+                    request->was_cached(),
+                    request->response_info().connection_info);
 }
 
 void AtomNetworkDelegate::OnURLRequestDestroyed(net::URLRequest* request) {
@@ -418,7 +517,7 @@ int AtomNetworkDelegate::HandleResponseEvent(
     return net::OK;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
 
   // The |request| could be destroyed before the |callback| is called.
   callbacks_[request->identifier()] = callback;
@@ -441,7 +540,7 @@ void AtomNetworkDelegate::HandleSimpleEvent(
     return;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
 
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
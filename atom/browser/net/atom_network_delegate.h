@@ -7,22 +7,21 @@
 
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 
+#include "atom/browser/net/url_pattern_matcher.h"
 #include "base/callback.h"
 #include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "brightray/browser/network_delegate.h"
 #include "content/public/browser/resource_request_info.h"
-#include "extensions/common/url_pattern.h"
 #include "net/base/net_errors.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 
 namespace atom {
 
-using URLPatterns = std::set<URLPattern>;
+class WebRequestRules;
 
 const char* ResourceTypeToString(content::ResourceType type);
 
@@ -47,26 +46,59 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
     kOnHeadersReceived,
   };
 
+  // Fields of the details object passed to listeners, a listener only pays
+  // for building the fields it asked for.
+  enum DetailsField : uint32_t {
+    kFieldId = 1 << 0,
+    kFieldUrl = 1 << 1,
+    kFieldMethod = 1 << 2,
+    kFieldReferrer = 1 << 3,
+    kFieldUploadData = 1 << 4,
+    kFieldTimestamp = 1 << 5,
+    kFieldFirstPartyUrl = 1 << 6,
+    kFieldResourceType = 1 << 7,
+    kFieldTabId = 1 << 8,
+    kFieldRequestHeaders = 1 << 9,
+    kFieldResponseHeaders = 1 << 10,
+    kFieldStatus = 1 << 11,
+    kFieldRedirectUrl = 1 << 12,
+    kFieldIp = 1 << 13,
+    kFieldFromCache = 1 << 14,
+    kFieldError = 1 << 15,
+    kFieldProtocol = 1 << 16,
+    kFieldAll = 0xFFFFFFFF,
+  };
+
   struct SimpleListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
+    uint32_t fields;
     SimpleListener listener;
   };
 
   struct ResponseListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
+    uint32_t fields;
     ResponseListener listener;
   };
 
+  // Returns the DetailsField for the JS property |name|, or 0 if unknown.
+  static uint32_t DetailsFieldFromString(const std::string& name);
+
   AtomNetworkDelegate();
   ~AtomNetworkDelegate() override;
 
   void SetSimpleListenerInIO(SimpleEvent type,
                              const URLPatterns& patterns,
+                             uint32_t fields,
                              const SimpleListener& callback);
   void SetResponseListenerInIO(ResponseEvent type,
                                const URLPatterns& patterns,
+                               uint32_t fields,
                                const ResponseListener& callback);
 
+  // Replaces the declarative rules, or clears them when |rules| is null.
+  void SetRulesInIO(std::unique_ptr<WebRequestRules> rules);
+
   void SetDevToolsNetworkEmulationClientId(const std::string& client_id);
 
  protected:
@@ -117,6 +149,9 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
   std::map<uint64_t, net::CompletionCallback> callbacks_;
 
+  // Evaluated before the listeners, only accessed on the IO thread.
+  std::unique_ptr<WebRequestRules> rules_;
+
   base::Lock lock_;
 
   // Client id for devtools network emulation.
@@ -0,0 +1,124 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_pattern_matcher.h"
+
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+// Lower case without a trailing dot, so hosts that URLPattern considers equal
+// always land in the same bucket.
+std::string CanonicalizeHost(const std::string& host) {
+  std::string result = base::ToLowerASCII(host);
+  if (!result.empty() && result.back() == '.')
+    result.pop_back();
+  return result;
+}
+
+// GURL hosts are already lower case.
+base::StringPiece StripTrailingDot(base::StringPiece host) {
+  if (!host.empty() && host[host.size() - 1] == '.')
+    host.remove_suffix(1);
+  return host;
+}
+
+}  // namespace
+
+URLPatternMatcher::URLPatternMatcher() {
+}
+
+URLPatternMatcher::URLPatternMatcher(const URLPatterns& patterns)
+    : patterns_(patterns.begin(), patterns.end()) {
+  Build();
+}
+
+URLPatternMatcher::URLPatternMatcher(const URLPatternMatcher& other)
+    : patterns_(other.patterns_) {
+  Build();
+}
+
+URLPatternMatcher::~URLPatternMatcher() {
+}
+
+URLPatternMatcher& URLPatternMatcher::operator=(
+    const URLPatternMatcher& other) {
+  if (this != &other) {
+    patterns_ = other.patterns_;
+    Build();
+  }
+  return *this;
+}
+
+bool URLPatternMatcher::MatchesURL(const GURL& url) const {
+  if (patterns_.empty())
+    return true;
+
+  if (MatchesAny(any_host_, url))
+    return true;
+
+  // URLPattern matches filesystem: URLs by their inner URL.
+  const GURL* test_url = &url;
+  if (url.SchemeIsFileSystem() && url.inner_url())
+    test_url = url.inner_url();
+
+  base::StringPiece host = StripTrailingDot(test_url->host_piece());
+  if (host.empty())
+    return false;
+
+  auto exact = exact_hosts_.find(host);
+  if (exact != exact_hosts_.end() && MatchesAny(exact->second, url))
+    return true;
+
+  if (subdomain_hosts_.empty())
+    return false;
+
+  // Walk "a.b.example.com", "b.example.com", "example.com", "com".
+  while (true) {
+    auto it = subdomain_hosts_.find(host);
+    if (it != subdomain_hosts_.end() && MatchesAny(it->second, url))
+      return true;
+
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      return false;
+    host.remove_prefix(dot + 1);
+  }
+}
+
+void URLPatternMatcher::Build() {
+  hosts_.clear();
+  any_host_.clear();
+  exact_hosts_.clear();
+  subdomain_hosts_.clear();
+
+  // Fill |hosts_| completely first, the maps keep pointers into it.
+  hosts_.reserve(patterns_.size());
+  for (const auto& pattern : patterns_)
+    hosts_.push_back(CanonicalizeHost(pattern.host()));
+
+  for (size_t i = 0; i < patterns_.size(); ++i) {
+    const URLPattern& pattern = patterns_[i];
+    if (pattern.match_all_urls() || hosts_[i].empty())
+      any_host_.push_back(i);
+    else if (pattern.match_subdomains())
+      subdomain_hosts_[hosts_[i]].push_back(i);
+    else
+      exact_hosts_[hosts_[i]].push_back(i);
+  }
+}
+
+bool URLPatternMatcher::MatchesAny(const std::vector<size_t>& candidates,
+                                   const GURL& url) const {
+  for (size_t index : candidates) {
+    if (patterns_[index].MatchesURL(url))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace atom
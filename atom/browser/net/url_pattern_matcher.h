@@ -0,0 +1,63 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+#define ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace atom {
+
+using URLPatterns = std::set<URLPattern>;
+
+// Matches URLs against a set of URLPatterns without scanning all of them.
+//
+// Patterns are bucketed by host: patterns for an exact host are looked up by
+// the URL's host, and "*.host" patterns by every dot-separated suffix of it.
+// Patterns without a host (<all_urls>, "*://*/*", file URLs) are always
+// candidates. Each candidate is confirmed with URLPattern::MatchesURL, so the
+// result is exactly that of testing every pattern.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  explicit URLPatternMatcher(const URLPatterns& patterns);
+  URLPatternMatcher(const URLPatternMatcher& other);
+  ~URLPatternMatcher();
+
+  URLPatternMatcher& operator=(const URLPatternMatcher& other);
+
+  // Returns true if |url| matches any pattern, or if there are no patterns.
+  bool MatchesURL(const GURL& url) const;
+
+  bool is_empty() const { return patterns_.empty(); }
+
+ private:
+  using HostMap = std::unordered_map<base::StringPiece,
+                                     std::vector<size_t>,
+                                     base::StringPieceHash>;
+
+  void Build();
+  bool MatchesAny(const std::vector<size_t>& candidates,
+                  const GURL& url) const;
+
+  std::vector<URLPattern> patterns_;
+  // Canonical hosts of |patterns_|, which the keys of the maps point into.
+  std::vector<std::string> hosts_;
+
+  std::vector<size_t> any_host_;
+  HostMap exact_hosts_;
+  HostMap subdomain_hosts_;
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
@@ -0,0 +1,321 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/web_request_rules.h"
+
+#include "atom/browser/net/atom_network_delegate.h"
+#include "base/values.h"
+#include "content/public/browser/resource_request_info.h"
+#include "content/public/common/resource_type.h"
+#include "net/base/net_errors.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+bool ParsePatterns(const base::DictionaryValue& dict,
+                   const std::string& key,
+                   URLPatternMatcher* matcher,
+                   std::string* error) {
+  const base::ListValue* list = nullptr;
+  if (!dict.HasKey(key))
+    return true;
+  if (!dict.GetList(key, &list)) {
+    *error = key + " must be an array of URL patterns";
+    return false;
+  }
+
+  URLPatterns patterns;
+  for (size_t i = 0; i < list->GetSize(); ++i) {
+    std::string value;
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    if (!list->GetString(i, &value) ||
+        pattern.Parse(value) != URLPattern::PARSE_SUCCESS) {
+      *error = "Invalid URL pattern in " + key;
+      return false;
+    }
+    patterns.insert(pattern);
+  }
+  *matcher = URLPatternMatcher(patterns);
+  return true;
+}
+
+bool ParseHeaderNames(const base::DictionaryValue& dict,
+                      const std::string& key,
+                      std::vector<std::string>* names,
+                      std::string* error) {
+  const base::ListValue* list = nullptr;
+  if (!dict.HasKey(key))
+    return true;
+  if (!dict.GetList(key, &list)) {
+    *error = key + " must be an array of header names";
+    return false;
+  }
+
+  for (size_t i = 0; i < list->GetSize(); ++i) {
+    std::string name;
+    if (!list->GetString(i, &name) || !net::HttpUtil::IsValidHeaderName(name)) {
+      *error = "Invalid header name in " + key;
+      return false;
+    }
+    names->push_back(name);
+  }
+  return true;
+}
+
+bool ParseHeaderValues(const base::DictionaryValue& dict,
+                       const std::string& key,
+                       std::map<std::string, std::string>* headers,
+                       std::string* error) {
+  const base::DictionaryValue* values = nullptr;
+  if (!dict.HasKey(key))
+    return true;
+  if (!dict.GetDictionary(key, &values)) {
+    *error = key + " must be an object";
+    return false;
+  }
+
+  for (base::DictionaryValue::Iterator it(*values); !it.IsAtEnd();
+       it.Advance()) {
+    std::string value;
+    if (!net::HttpUtil::IsValidHeaderName(it.key()) ||
+        !it.value().GetAsString(&value) ||
+        !net::HttpUtil::IsValidHeaderValue(value)) {
+      *error = "Invalid header in " + key;
+      return false;
+    }
+    (*headers)[it.key()] = value;
+  }
+  return true;
+}
+
+// Whether |type| is one of the names ResourceTypeToString() reports.
+bool IsValidResourceType(const std::string& type) {
+  if (type == "other")
+    return true;
+  for (int i = 0; i < content::RESOURCE_TYPE_LAST_TYPE; ++i) {
+    if (type == ResourceTypeToString(static_cast<content::ResourceType>(i)))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+WebRequestRules::HeaderChanges::HeaderChanges() {
+}
+
+WebRequestRules::HeaderChanges::HeaderChanges(const HeaderChanges& other) =
+    default;
+
+WebRequestRules::HeaderChanges::~HeaderChanges() {
+}
+
+WebRequestRules::Rule::Rule() : party(PARTY_ANY), action(ACTION_NONE) {
+}
+
+WebRequestRules::Rule::Rule(const Rule& other) = default;
+
+WebRequestRules::Rule::~Rule() {
+}
+
+WebRequestRules::WebRequestRules()
+    : has_actions_(false),
+      has_request_headers_(false),
+      has_response_headers_(false) {
+}
+
+WebRequestRules::~WebRequestRules() {
+}
+
+// static
+std::unique_ptr<WebRequestRules> WebRequestRules::Create(
+    const base::ListValue& rules, std::string* error) {
+  std::unique_ptr<WebRequestRules> result(new WebRequestRules);
+  for (size_t i = 0; i < rules.GetSize(); ++i) {
+    const base::DictionaryValue* dict = nullptr;
+    if (!rules.GetDictionary(i, &dict)) {
+      *error = "Each rule must be an object";
+      return nullptr;
+    }
+
+    Rule rule;
+    if (!ParseRule(*dict, &rule, error))
+      return nullptr;
+
+    result->has_actions_ |= rule.action != ACTION_NONE;
+    result->has_request_headers_ |= !rule.request_headers.empty();
+    result->has_response_headers_ |= !rule.response_headers.empty();
+    result->rules_.push_back(rule);
+  }
+  return result;
+}
+
+bool WebRequestRules::OnBeforeRequest(net::URLRequest* request,
+                                      GURL* new_url,
+                                      int* result) const {
+  if (!has_actions_)
+    return false;
+
+  for (const Rule& rule : rules_) {
+    if (rule.action == ACTION_NONE || !Matches(rule, request))
+      continue;
+
+    switch (rule.action) {
+      case ACTION_BLOCK:
+        *result = net::ERR_BLOCKED_BY_CLIENT;
+        break;
+      case ACTION_REDIRECT:
+        // Do not redirect a request that is already at the target, or the
+        // rule would loop forever.
+        if (request->url() == rule.redirect_url)
+          continue;
+        *new_url = rule.redirect_url;
+        *result = net::OK;
+        break;
+      default:
+        *result = net::OK;
+        break;
+    }
+    return true;
+  }
+  return false;
+}
+
+bool WebRequestRules::OnBeforeSendHeaders(
+    net::URLRequest* request, net::HttpRequestHeaders* headers) const {
+  if (!has_request_headers_)
+    return false;
+
+  bool modified = false;
+  for (const Rule& rule : rules_) {
+    if (rule.request_headers.empty() || !Matches(rule, request))
+      continue;
+
+    for (const auto& name : rule.request_headers.remove)
+      headers->RemoveHeader(name);
+    for (const auto& header : rule.request_headers.set)
+      headers->SetHeader(header.first, header.second);
+    modified = true;
+  }
+  return modified;
+}
+
+bool WebRequestRules::OnHeadersReceived(
+    net::URLRequest* request,
+    const net::HttpResponseHeaders* original,
+    scoped_refptr<net::HttpResponseHeaders>* override) const {
+  if (!has_response_headers_ || !original)
+    return false;
+
+  for (const Rule& rule : rules_) {
+    if (rule.response_headers.empty() || !Matches(rule, request))
+      continue;
+
+    if (!override->get())
+      *override = new net::HttpResponseHeaders(original->raw_headers());
+    for (const auto& name : rule.response_headers.remove)
+      (*override)->RemoveHeader(name);
+    for (const auto& header : rule.response_headers.set) {
+      (*override)->RemoveHeader(header.first);
+      (*override)->AddHeader(header.first + ": " + header.second);
+    }
+  }
+  return override->get() != nullptr;
+}
+
+// static
+bool WebRequestRules::ParseRule(const base::DictionaryValue& dict,
+                                Rule* rule,
+                                std::string* error) {
+  if (!ParsePatterns(dict, "urls", &rule->urls, error) ||
+      !ParsePatterns(dict, "firstPartyUrls", &rule->first_party_urls, error))
+    return false;
+
+  const base::ListValue* types = nullptr;
+  if (dict.HasKey("resourceTypes")) {
+    if (!dict.GetList("resourceTypes", &types)) {
+      *error = "resourceTypes must be an array of resource types";
+      return false;
+    }
+    for (size_t i = 0; i < types->GetSize(); ++i) {
+      std::string type;
+      if (!types->GetString(i, &type) || !IsValidResourceType(type)) {
+        *error = "Invalid resource type in resourceTypes";
+        return false;
+      }
+      rule->resource_types.insert(type);
+    }
+  }
+
+  bool third_party;
+  if (dict.GetBoolean("thirdParty", &third_party))
+    rule->party = third_party ? PARTY_THIRD : PARTY_FIRST;
+
+  std::string action;
+  if (dict.GetString("action", &action)) {
+    if (action == "block") {
+      rule->action = ACTION_BLOCK;
+    } else if (action == "allow") {
+      rule->action = ACTION_ALLOW;
+    } else if (action == "redirect") {
+      std::string url;
+      rule->action = ACTION_REDIRECT;
+      if (dict.GetString("redirectURL", &url))
+        rule->redirect_url = GURL(url);
+      if (!rule->redirect_url.is_valid()) {
+        *error = "A redirect rule requires a valid redirectURL";
+        return false;
+      }
+    } else {
+      *error = "Unknown rule action: " + action;
+      return false;
+    }
+  }
+
+  return ParseHeaderValues(dict, "setRequestHeaders",
+                           &rule->request_headers.set, error) &&
+         ParseHeaderNames(dict, "removeRequestHeaders",
+                          &rule->request_headers.remove, error) &&
+         ParseHeaderValues(dict, "setResponseHeaders",
+                           &rule->response_headers.set, error) &&
+         ParseHeaderNames(dict, "removeResponseHeaders",
+                          &rule->response_headers.remove, error);
+}
+
+// static
+bool WebRequestRules::Matches(const Rule& rule, net::URLRequest* request) {
+  if (!rule.urls.MatchesURL(request->url()))
+    return false;
+
+  const GURL& first_party = request->first_party_for_cookies();
+  if (!rule.first_party_urls.MatchesURL(first_party))
+    return false;
+
+  if (!rule.resource_types.empty()) {
+    auto info = content::ResourceRequestInfo::ForRequest(request);
+    const char* type =
+        info ? ResourceTypeToString(info->GetResourceType()) : "other";
+    if (rule.resource_types.find(type) == rule.resource_types.end())
+      return false;
+  }
+
+  if (rule.party != PARTY_ANY) {
+    bool same_site = first_party.is_empty() ||
+        net::registry_controlled_domains::SameDomainOrHost(
+            request->url(), first_party,
+            net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+    if (same_site != (rule.party == PARTY_FIRST))
+      return false;
+  }
+
+  return true;
+}
+
+}  // namespace atom
@@ -0,0 +1,120 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "atom/browser/net/url_pattern_matcher.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "url/gurl.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+class URLRequest;
+}
+
+namespace atom {
+
+// Declarative webRequest rules that are evaluated on the IO thread, so
+// requests they decide never wait for a JS listener on the UI thread.
+//
+// The first matching block/redirect/allow rule decides onBeforeRequest,
+// undecided requests fall back to the JS listeners. All matching header rules
+// are applied in order for onBeforeSendHeaders and onHeadersReceived, before
+// the JS listeners of those stages run.
+class WebRequestRules {
+ public:
+  // Parses |rules|, returns nullptr and sets |error| if one is invalid.
+  static std::unique_ptr<WebRequestRules> Create(const base::ListValue& rules,
+                                                 std::string* error);
+
+  ~WebRequestRules();
+
+  // Returns true if a rule decided the request, with the net error in
+  // |result| and |new_url| set for redirects.
+  bool OnBeforeRequest(net::URLRequest* request, GURL* new_url,
+                       int* result) const;
+
+  // Applies the matching header rules to |headers|, returns true if there
+  // was one.
+  bool OnBeforeSendHeaders(net::URLRequest* request,
+                           net::HttpRequestHeaders* headers) const;
+
+  // Returns true if a rule replaced the response headers with |override|.
+  bool OnHeadersReceived(
+      net::URLRequest* request,
+      const net::HttpResponseHeaders* original,
+      scoped_refptr<net::HttpResponseHeaders>* override) const;
+
+ private:
+  enum Action {
+    ACTION_NONE,
+    ACTION_ALLOW,
+    ACTION_BLOCK,
+    ACTION_REDIRECT,
+  };
+
+  enum PartyFilter {
+    PARTY_ANY,
+    PARTY_FIRST,
+    PARTY_THIRD,
+  };
+
+  struct HeaderChanges {
+    HeaderChanges();
+    HeaderChanges(const HeaderChanges& other);
+    ~HeaderChanges();
+
+    bool empty() const { return set.empty() && remove.empty(); }
+
+    std::map<std::string, std::string> set;
+    std::vector<std::string> remove;
+  };
+
+  struct Rule {
+    Rule();
+    Rule(const Rule& other);
+    ~Rule();
+
+    URLPatternMatcher urls;
+    URLPatternMatcher first_party_urls;
+    std::set<std::string> resource_types;
+    PartyFilter party;
+    Action action;
+    GURL redirect_url;
+    HeaderChanges request_headers;
+    HeaderChanges response_headers;
+  };
+
+  WebRequestRules();
+
+  static bool ParseRule(const base::DictionaryValue& dict, Rule* rule,
+                        std::string* error);
+  static bool Matches(const Rule& rule, net::URLRequest* request);
+
+  std::vector<Rule> rules_;
+  // Whether any rule has an effect on each stage, to skip matching early.
+  bool has_actions_;
+  bool has_request_headers_;
+  bool has_response_headers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRequestRules);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
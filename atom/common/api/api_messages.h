@@ -4,6 +4,10 @@
 
 // Multiply-included file, no traditional include guard.
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "base/strings/string16.h"
 #include "base/memory/shared_memory.h"
 #include "base/values.h"
@@ -16,33 +20,79 @@
 
 #define IPC_MESSAGE_START ShellMsgStart
 
+// Arguments written with v8::ValueSerializer, see
+// brave/common/serialized_args.h. Large payloads are sent in a read-only
+// shared memory segment instead of being copied into the message, in which
+// case |data| is empty.
+IPC_STRUCT_BEGIN(AtomMsg_SerializedArgs)
+  IPC_STRUCT_MEMBER(std::vector<uint8_t>, data)
+  IPC_STRUCT_MEMBER(base::SharedMemoryHandle, shared_data)
+  IPC_STRUCT_MEMBER(uint32_t, shared_data_size, 0)
+IPC_STRUCT_END()
+
+// A value serialized by brave::SharedMemoryWrapper, |size| bytes after the
+// segment header. Pooled segments are shared writable so the reader can
+// release them for reuse, readers copy the value out before parsing it.
+IPC_STRUCT_BEGIN(AtomMsg_SharedSegment)
+  IPC_STRUCT_MEMBER(base::SharedMemoryHandle, handle)
+  IPC_STRUCT_MEMBER(uint32_t, size, 0)
+  IPC_STRUCT_MEMBER(bool, pooled, false)
+IPC_STRUCT_END()
+
 IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+// Both sync messages are replied to with a serialized value, so replies
+// never go through JSON.
 IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync,
                            base::string16 /* channel */,
                            base::ListValue /* arguments */,
-                           base::string16 /* result (in JSON) */)
+                           AtomMsg_SerializedArgs /* result */)
+
+IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync_Serialized,
+                           base::string16 /* channel */,
+                           AtomMsg_SerializedArgs /* arguments */,
+                           AtomMsg_SerializedArgs /* result */)
+
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Serialized,
+                    base::string16 /* channel */,
+                    AtomMsg_SerializedArgs /* arguments */)
 
 IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Shared,
                     base::string16 /* channel */,
-                    base::SharedMemoryHandle /* arguments */)
+                    AtomMsg_SharedSegment /* arguments */)
 
 IPC_MESSAGE_ROUTED3(AtomViewMsg_Message,
                     bool /* send_to_all */,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+IPC_MESSAGE_ROUTED3(AtomViewMsg_Message_Serialized,
+                    bool /* send_to_all */,
+                    base::string16 /* channel */,
+                    AtomMsg_SerializedArgs /* arguments */)
+
 IPC_MESSAGE_ROUTED2(AtomViewMsg_Message_Shared,
                     base::string16 /* channel */,
-                    base::SharedMemoryHandle /* arguments */)
+                    AtomMsg_SharedSegment /* arguments */)
 
 // Update renderer process preferences.
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdatePreferences, base::ListValue)
 
-// Update renderer content settings
-IPC_MESSAGE_CONTROL1(AtomMsg_UpdateContentSettings, base::DictionaryValue)
+// Replace renderer content settings
+IPC_MESSAGE_CONTROL2(AtomMsg_UpdateContentSettings,
+                     int /* version */,
+                     base::DictionaryValue /* content settings */)
+
+// Update renderer content settings from |base version| to |version|
+IPC_MESSAGE_CONTROL3(AtomMsg_UpdateContentSettingsDelta,
+                     int /* base version */,
+                     int /* version */,
+                     base::ListValue /* splices */)
+
+// Ask for the full content settings after a delta could not be applied
+IPC_MESSAGE_CONTROL0(AtomHostMsg_RequestContentSettings)
 
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateWebKitPrefs, content::WebPreferences)
@@ -4,11 +4,14 @@
 
 #include <stddef.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "atom_natives.h"  // NOLINT: This file is generated with coffee2c.
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
@@ -23,10 +26,11 @@ class Archive : public mate::Wrappable<Archive> {
  public:
   static v8::Local<v8::Value> Create(v8::Isolate* isolate,
                                       const base::FilePath& path) {
-    std::unique_ptr<asar::Archive> archive(new asar::Archive(path));
-    if (!archive->Init())
+    // Share the compiled index with the native asar readers.
+    std::shared_ptr<asar::Archive> archive = asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return v8::False(isolate);
-    return (new Archive(isolate, std::move(archive)))->GetWrapper();
+    return (new Archive(isolate, archive))->GetWrapper();
   }
 
   static void BuildPrototype(
@@ -39,13 +43,15 @@ class Archive : public mate::Wrappable<Archive> {
         .SetMethod("readdir", &Archive::Readdir)
         .SetMethod("realpath", &Archive::Realpath)
         .SetMethod("copyFileOut", &Archive::CopyFileOut)
+        .SetMethod("readFileString", &Archive::ReadFileString)
+        .SetMethod("readFileBuffer", &Archive::ReadFileBuffer)
         .SetMethod("getFd", &Archive::GetFD)
         .SetMethod("destroy", &Archive::Destroy);
   }
 
  protected:
-  Archive(v8::Isolate* isolate, std::unique_ptr<asar::Archive> archive)
-      : archive_(std::move(archive)) {
+  Archive(v8::Isolate* isolate, std::shared_ptr<asar::Archive> archive)
+      : archive_(archive) {
     Init(isolate);
   }
 
@@ -64,6 +70,8 @@ class Archive : public mate::Wrappable<Archive> {
     dict.Set("size", info.size);
     dict.Set("unpacked", info.unpacked);
     dict.Set("offset", info.offset);
+    if (info.compressed)
+      dict.Set("compressedSize", info.compressed_size);
     return dict.GetHandle();
   }
 
@@ -109,6 +117,45 @@ class Archive : public mate::Wrappable<Archive> {
     return mate::ConvertToV8(isolate, new_path);
   }
 
+  // Reads a packed file as UTF-8, straight from the mapped archive when it is
+  // stored uncompressed.
+  v8::Local<v8::Value> ReadFileString(v8::Isolate* isolate,
+                                      const base::FilePath& path) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) || info.unpacked)
+      return v8::False(isolate);
+
+    base::StringPiece data;
+    if (!info.compressed &&
+        archive_->GetMappedData(info.offset, info.size, &data))
+      return mate::StringToV8(isolate, data);
+
+    std::string contents;
+    if (!archive_->ReadFile(info, &contents))
+      return v8::False(isolate);
+    return mate::StringToV8(isolate, contents);
+  }
+
+  // Reads a packed file into a Buffer.
+  v8::Local<v8::Value> ReadFileBuffer(v8::Isolate* isolate,
+                                      const base::FilePath& path) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) || info.unpacked)
+      return v8::False(isolate);
+
+    base::StringPiece data;
+    if (!info.compressed &&
+        archive_->GetMappedData(info.offset, info.size, &data))
+      return node::Buffer::Copy(isolate, data.data(), data.size())
+          .ToLocalChecked();
+
+    std::string contents;
+    if (!archive_->ReadFile(info, &contents))
+      return v8::False(isolate);
+    return node::Buffer::Copy(isolate, contents.data(), contents.size())
+        .ToLocalChecked();
+  }
+
   // Return the file descriptor.
   int GetFD() const {
     if (!archive_)
@@ -122,7 +169,7 @@ class Archive : public mate::Wrappable<Archive> {
   }
 
  private:
-  std::unique_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
@@ -9,8 +9,10 @@
 #include <memory>
 #include <string>
 
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/atom_version.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
 #include "base/logging.h"
 #include "base/process/process_metrics.h"
@@ -78,6 +80,36 @@ v8::Local<v8::Value> GetSystemMemoryInfo(v8::Isolate* isolate,
   return dict.GetHandle();
 }
 
+v8::Local<v8::Value> GetAsarCacheInfo(v8::Isolate* isolate) {
+  asar::ArchiveCacheStats stats = asar::GetArchiveCacheStats();
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("hits", static_cast<double>(stats.hits));
+  dict.Set("misses", static_cast<double>(stats.misses));
+  dict.Set("opens", static_cast<double>(stats.opens));
+  dict.Set("failures", static_cast<double>(stats.failures));
+  dict.Set("evictions", static_cast<double>(stats.evictions));
+  dict.Set("size", static_cast<double>(stats.size));
+  dict.Set("capacity", static_cast<double>(stats.capacity));
+  return dict.GetHandle();
+}
+
+void SetAsarCacheCapacity(uint32_t capacity) {
+  asar::SetArchiveCacheCapacity(capacity);
+}
+
+v8::Local<v8::Value> GetUvLoopInfo(v8::Isolate* isolate) {
+  UvLoopStats stats = GetUvLoopStats();
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("wakeups", static_cast<double>(stats.wakeups));
+  dict.Set("iterations", static_cast<double>(stats.iterations));
+  dict.Set("averageLatency", stats.wakeups > 0 ?
+      stats.total_latency.InMillisecondsF() / stats.wakeups : 0.0);
+  dict.Set("maxLatency", stats.max_latency.InMillisecondsF());
+  return dict.GetHandle();
+}
+
 // Called when there is a fatal error in V8, we just crash the process here so
 // we can get the stack trace.
 void FatalErrorCallback(const char* location, const char* message) {
@@ -110,6 +142,9 @@ void AtomBindings::BindTo(v8::Isolate* isolate,
   dict.SetMethod("log", &Log);
   dict.SetMethod("getProcessMemoryInfo", &GetProcessMemoryInfo);
   dict.SetMethod("getSystemMemoryInfo", &GetSystemMemoryInfo);
+  dict.SetMethod("getAsarCacheInfo", &GetAsarCacheInfo);
+  dict.SetMethod("setAsarCacheCapacity", &SetAsarCacheCapacity);
+  dict.SetMethod("getUvLoopInfo", &GetUvLoopInfo);
 #if defined(OS_POSIX)
   dict.SetMethod("setFdLimit", &base::SetFdLimit);
 #endif
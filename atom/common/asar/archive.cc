@@ -8,14 +8,15 @@
 #include <utility>
 #include <vector>
 
+#include "atom/common/asar/archive_index.h"
 #include "atom/common/asar/scoped_temporary_file.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/pickle.h"
-#include "base/strings/string_number_conversions.h"
 #include "base/values.h"
+#include "third_party/zlib/zlib.h"
 
 #if defined(OS_WIN)
 #include "atom/node/osfhandle.h"
@@ -27,91 +28,40 @@ namespace asar {
 
 namespace {
 
-#if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
-#endif
-
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  std::string link;
-  if (dir->GetStringWithoutPathExpansion("link", &link)) {
-    const base::DictionaryValue* linked_node = nullptr;
-    if (!GetNodeFromPath(link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
-
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
-}
-
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* files = nullptr;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
-}
-
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = nullptr;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
+// Inflates the gzip stream |input| into exactly |size| bytes at |output|.
+bool GzipUncompress(const base::StringPiece& input, char* output,
+                    uint32_t size) {
+  z_stream stream = {};
+  // 16 selects the gzip wrapper.
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+    return false;
 
-    dir = child;
-    path.erase(0, delimiter_position + 1);
-  }
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = static_cast<uInt>(input.size());
+  stream.next_out = reinterpret_cast<Bytef*>(output);
+  stream.avail_out = size;
+  int result = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
 
-  return GetChildNode(root, path, dir, out);
+  return result == Z_STREAM_END && stream.avail_out == 0;
 }
 
-bool FillFileInfoWithNode(Archive::FileInfo* info,
-                          uint32_t header_size,
-                          const base::DictionaryValue* node) {
-  int size;
-  if (!node->GetInteger("size", &size))
+bool FillFileInfoWithEntry(Archive::FileInfo* info,
+                           const ArchiveIndex::Entry& entry) {
+  if (entry.flags & (ArchiveIndex::FLAG_DIRECTORY | ArchiveIndex::FLAG_LINK |
+                     ArchiveIndex::FLAG_INVALID))
     return false;
-  info->size = static_cast<uint32_t>(size);
 
-  if (node->GetBoolean("unpacked", &info->unpacked) && info->unpacked)
+  info->size = entry.size;
+  info->unpacked = (entry.flags & ArchiveIndex::FLAG_UNPACKED) != 0;
+  if (info->unpacked)
     return true;
 
-  std::string offset;
-  if (!node->GetString("offset", &offset))
-    return false;
-  if (!base::StringToUint64(offset, &info->offset))
-    return false;
-  info->offset += header_size;
-
-  node->GetBoolean("executable", &info->executable);
-
+  info->offset = entry.offset;
+  info->executable = (entry.flags & ArchiveIndex::FLAG_EXECUTABLE) != 0;
+  info->compressed = (entry.flags & ArchiveIndex::FLAG_COMPRESSED) != 0;
+  info->compressed_size = entry.compressed_size;
   return true;
 }
 
@@ -191,80 +141,121 @@ bool Archive::Init() {
   }
 
   header_size_ = 8 + size;
-  header_.reset(static_cast<base::DictionaryValue*>(value.release()));
+  index_ = ArchiveIndex::Create(
+      *static_cast<base::DictionaryValue*>(value.get()), header_size_);
   return true;
 }
 
-bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
-  if (!header_)
+bool Archive::MapFile() {
+  if (mapped_file_.IsValid())
+    return true;
+  if (!file_.IsValid())
+    return false;
+
+  // Map a duplicate so |file_| and |fd_| stay usable for the JS fs shim.
+  if (!mapped_file_.Initialize(file_.Duplicate())) {
+    LOG(WARNING) << "Failed to map " << path_.value();
     return false;
+  }
+  return true;
+}
+
+bool Archive::GetMappedData(uint64_t offset, uint32_t size,
+                            base::StringPiece* data) const {
+  if (!mapped_file_.IsValid())
+    return false;
+  if (offset > mapped_file_.length() || size > mapped_file_.length() - offset)
+    return false;
+
+  *data = base::StringPiece(
+      reinterpret_cast<const char*>(mapped_file_.data()) + offset, size);
+  return true;
+}
+
+bool Archive::ReadFile(const FileInfo& info, std::string* contents) {
+  base::StringPiece data;
+  std::string stored;
+  if (!GetMappedData(info.offset, info.stored_size(), &data)) {
+    stored.resize(info.stored_size());
+    int size = static_cast<int>(stored.size());
+    if (file_.Read(info.offset, &stored[0], size) != size)
+      return false;
+    data = stored;
+  }
+
+  if (!info.compressed) {
+    data.CopyToString(contents);
+    return true;
+  }
+
+  contents->resize(info.size);
+  return GzipUncompress(data, &(*contents)[0], info.size);
+}
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
+  if (!index_)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
+  uint32_t entry = index_->ResolveLinks(LookupEntry(path));
+  if (entry == ArchiveIndex::kInvalidEntry)
+    return false;
 
-  return FillFileInfoWithNode(info, header_size_, node);
+  return FillFileInfoWithEntry(info, index_->entry(entry));
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  uint32_t entry = LookupEntry(path);
+  if (entry == ArchiveIndex::kInvalidEntry)
     return false;
 
-  if (node->HasKey("link")) {
+  uint32_t flags = index_->entry(entry).flags;
+  if (flags & ArchiveIndex::FLAG_LINK) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->HasKey("files")) {
+  if (flags & ArchiveIndex::FLAG_DIRECTORY) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, node);
+  return FillFileInfoWithEntry(stats, index_->entry(entry));
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
-  if (!header_)
-    return false;
-
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* files;
-  if (!GetFilesNode(header_.get(), node, &files))
+  uint32_t dir = index_->GetDirectory(LookupEntry(path));
+  if (dir == ArchiveIndex::kInvalidEntry)
     return false;
 
-  base::DictionaryValue::Iterator iter(*files);
-  while (!iter.IsAtEnd()) {
-    list->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
+  const ArchiveIndex::Entry& entry = index_->entry(dir);
+  list->reserve(list->size() + entry.child_count);
+  for (uint32_t i = 0; i < entry.child_count; ++i) {
+    list->push_back(base::FilePath::FromUTF8Unsafe(
+        index_->GetName(entry.first_child + i).as_string()));
   }
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  uint32_t entry = LookupEntry(path);
+  if (entry == ArchiveIndex::kInvalidEntry)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  if (index_->entry(entry).flags & ArchiveIndex::FLAG_LINK) {
+    *realpath = base::FilePath::FromUTF8Unsafe(
+        index_->GetLinkPath(entry).as_string());
     return true;
   }
 
@@ -273,6 +264,7 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  base::AutoLock auto_lock(external_files_lock_);
   auto it = external_files_.find(path.value());
   if (it != external_files_.end()) {
     *out = it->second->path();
@@ -290,8 +282,14 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
 
   std::unique_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
   base::FilePath::StringType ext = path.Extension();
-  if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
+  if (info.compressed) {
+    std::string contents;
+    if (!ReadFile(info, &contents) ||
+        !temp_file->InitFromData(ext, contents))
+      return false;
+  } else if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size)) {
     return false;
+  }
 
 #if defined(OS_POSIX)
   if (info.executable) {
@@ -309,4 +307,13 @@ int Archive::GetFD() const {
   return fd_;
 }
 
+uint32_t Archive::LookupEntry(const base::FilePath& path) const {
+#if defined(OS_WIN)
+  return index_->Lookup(path.AsUTF8Unsafe());
+#else
+  // The native path is already UTF-8, so look it up without a copy.
+  return index_->Lookup(path.value());
+#endif
+}
+
 }  // namespace asar
@@ -6,18 +6,19 @@
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
-
-namespace base {
-class DictionaryValue;
-}
+#include "base/files/memory_mapped_file.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 
 namespace asar {
 
+class ArchiveIndex;
 class ScopedTemporaryFile;
 
 // This class represents an asar package, and provides methods to read
@@ -25,10 +26,16 @@ class ScopedTemporaryFile;
 class Archive {
  public:
   struct FileInfo {
-    FileInfo() : unpacked(false), executable(false), size(0), offset(0) {}
+    FileInfo() : unpacked(false), executable(false), compressed(false),
+                 size(0), compressed_size(0), offset(0) {}
+    // Number of bytes the file occupies in the archive.
+    uint32_t stored_size() const { return compressed ? compressed_size : size; }
     bool unpacked;
     bool executable;
+    // The stored bytes are a gzip stream that expands to |size| bytes.
+    bool compressed;
     uint32_t size;
+    uint32_t compressed_size;
     uint64_t offset;
   };
 
@@ -45,6 +52,20 @@ class Archive {
   // Read and parse the header.
   bool Init();
 
+  // Maps the whole archive into memory, after which packed files can be read
+  // with GetMappedData without opening, seeking or copying. Returns false if
+  // the archive can not be mapped, in which case callers read from the file.
+  bool MapFile();
+
+  // Returns a read-only view of |size| bytes at |offset| of the mapped
+  // archive. The view is valid for as long as the archive is alive.
+  bool GetMappedData(uint64_t offset, uint32_t size,
+                     base::StringPiece* data) const;
+
+  // Reads the packed file described by |info| into |contents|, expanding it
+  // if it is compressed.
+  bool ReadFile(const FileInfo& info, std::string* contents);
+
   // Get the info of a file.
   bool GetFileInfo(const base::FilePath& path, FileInfo* info);
 
@@ -65,16 +86,21 @@ class Archive {
   int GetFD() const;
 
   base::FilePath path() const { return path_; }
-  base::DictionaryValue* header() const { return header_.get(); }
+  const ArchiveIndex* index() const { return index_.get(); }
 
  private:
+  // Returns the index entry of |path|, or ArchiveIndex::kInvalidEntry.
+  uint32_t LookupEntry(const base::FilePath& path) const;
+
   base::FilePath path_;
   base::File file_;
+  base::MemoryMappedFile mapped_file_;
   int fd_;
   uint32_t header_size_;
-  std::unique_ptr<base::DictionaryValue> header_;
+  std::unique_ptr<ArchiveIndex> index_;
 
-  // Cached external temporary files.
+  // Cached external temporary files, archives are shared between threads.
+  base::Lock external_files_lock_;
   std::unordered_map
     <base::FilePath::StringType, std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
@@ -0,0 +1,395 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/archive_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+
+namespace asar {
+
+namespace {
+
+const uint32_t kFNVOffsetBasis = 2166136261u;
+const uint32_t kFNVPrime = 16777619u;
+
+// Guards against link cycles.
+const int kMaxLinkDepth = 32;
+
+// Marks a link whose target has not been resolved yet while building.
+const uint32_t kUnresolvedLink = ArchiveIndex::kInvalidEntry - 1;
+
+inline bool IsSeparator(char c) {
+#if defined(OS_WIN)
+  return c == '/' || c == '\\';
+#else
+  return c == '/';
+#endif
+}
+
+// FNV-1a, with every separator hashed as '/' so that the hash of a path can
+// be extended one component at a time while building.
+inline uint32_t HashChar(uint32_t hash, char c) {
+  return (hash ^ static_cast<uint8_t>(IsSeparator(c) ? '/' : c)) * kFNVPrime;
+}
+
+uint32_t HashString(uint32_t hash, const base::StringPiece& str) {
+  for (char c : str)
+    hash = HashChar(hash, c);
+  return hash;
+}
+
+}  // namespace
+
+// static
+const uint32_t ArchiveIndex::kInvalidEntry;
+const uint32_t ArchiveIndex::kRootEntry;
+
+class ArchiveIndex::Builder {
+ public:
+  Builder(ArchiveIndex* index, uint32_t header_size)
+      : index_(index), header_size_(header_size) {}
+
+  void Build(const base::DictionaryValue& header) {
+    std::vector<const base::DictionaryValue*> nodes;
+    nodes.push_back(&header);
+    AddEntry(kInvalidEntry, base::StringPiece(), kFNVOffsetBasis);
+
+    // Breadth-first, so the children of each directory end up contiguous.
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+      FillEntry(i, *nodes[i]);
+      if (index_->entries_[i].flags & FLAG_DIRECTORY)
+        AddChildren(i, *nodes[i], &nodes);
+    }
+
+    BuildTable();
+    ResolveLinks();
+  }
+
+ private:
+  void AddEntry(uint32_t parent, const base::StringPiece& name,
+                uint32_t hash) {
+    Entry entry = {};
+    entry.parent = parent;
+    entry.name_offset = AddString(name);
+    entry.name_length = name.size();
+    entry.first_child = kInvalidEntry;
+    entry.link = kInvalidEntry;
+    index_->entries_.push_back(entry);
+    index_->hashes_.push_back(hash);
+  }
+
+  uint32_t AddString(const base::StringPiece& str) {
+    uint32_t offset = index_->strings_.size();
+    str.AppendToString(&index_->strings_);
+    return offset;
+  }
+
+  void FillEntry(uint32_t index, const base::DictionaryValue& node) {
+    Entry& entry = index_->entries_[index];
+
+    if (node.HasKey("link")) {
+      std::string link;
+      entry.flags |= FLAG_LINK;
+      if (node.GetStringWithoutPathExpansion("link", &link)) {
+        entry.link = kUnresolvedLink;
+        entry.link_offset = AddString(link);
+        entry.link_length = link.size();
+      }
+      return;
+    }
+
+    if (node.HasKey("files")) {
+      entry.flags |= FLAG_DIRECTORY;
+      return;
+    }
+
+    if (!FillFileEntry(&entry, node))
+      entry.flags |= FLAG_INVALID;
+  }
+
+  bool FillFileEntry(Entry* entry, const base::DictionaryValue& node) {
+    int size;
+    if (!node.GetIntegerWithoutPathExpansion("size", &size))
+      return false;
+    entry->size = static_cast<uint32_t>(size);
+
+    bool flag = false;
+    if (node.GetBooleanWithoutPathExpansion("unpacked", &flag) && flag) {
+      entry->flags |= FLAG_UNPACKED;
+      return true;
+    }
+
+    std::string offset;
+    if (!node.GetStringWithoutPathExpansion("offset", &offset) ||
+        !base::StringToUint64(offset, &entry->offset))
+      return false;
+    entry->offset += header_size_;
+
+    if (node.GetBooleanWithoutPathExpansion("executable", &flag) && flag)
+      entry->flags |= FLAG_EXECUTABLE;
+
+    std::string compression;
+    if (node.GetStringWithoutPathExpansion("compression", &compression)) {
+      int compressed_size;
+      if (compression != "gzip" ||
+          !node.GetIntegerWithoutPathExpansion("compressedSize",
+                                               &compressed_size))
+        return false;
+      entry->flags |= FLAG_COMPRESSED;
+      entry->compressed_size = static_cast<uint32_t>(compressed_size);
+    }
+
+    return true;
+  }
+
+  void AddChildren(uint32_t index,
+                   const base::DictionaryValue& node,
+                   std::vector<const base::DictionaryValue*>* nodes) {
+    const base::DictionaryValue* files = nullptr;
+    if (!node.GetDictionaryWithoutPathExpansion("files", &files))
+      return;
+
+    std::vector<std::pair<base::StringPiece, const base::DictionaryValue*>>
+        children;
+    for (base::DictionaryValue::Iterator it(*files); !it.IsAtEnd();
+         it.Advance()) {
+      // Empty names and names containing separators can never be reached by
+      // a lookup, so they are dropped.
+      const base::DictionaryValue* child = nullptr;
+      if (it.key().empty() ||
+          std::any_of(it.key().begin(), it.key().end(), IsSeparator) ||
+          !it.value().GetAsDictionary(&child))
+        continue;
+      children.push_back(std::make_pair(base::StringPiece(it.key()), child));
+    }
+    std::sort(children.begin(), children.end(),
+              [](const std::pair<base::StringPiece,
+                                 const base::DictionaryValue*>& a,
+                 const std::pair<base::StringPiece,
+                                 const base::DictionaryValue*>& b) {
+                return a.first < b.first;
+              });
+
+    uint32_t hash = index_->hashes_[index];
+    if (index != kRootEntry)
+      hash = HashChar(hash, '/');
+
+    index_->entries_[index].first_child = index_->entries_.size();
+    index_->entries_[index].child_count = children.size();
+    for (const auto& child : children) {
+      AddEntry(index, child.first, HashString(hash, child.first));
+      nodes->push_back(child.second);
+    }
+  }
+
+  void BuildTable() {
+    size_t capacity = 16;
+    while (capacity < index_->entries_.size() * 2)
+      capacity <<= 1;
+    index_->table_.assign(capacity, kInvalidEntry);
+
+    const size_t mask = capacity - 1;
+    for (uint32_t i = 0; i < index_->entries_.size(); ++i) {
+      size_t slot = index_->hashes_[i] & mask;
+      while (index_->table_[slot] != kInvalidEntry)
+        slot = (slot + 1) & mask;
+      index_->table_[slot] = i;
+    }
+  }
+
+  // Links may point through other links, so keep resolving until no more
+  // progress is made. Whatever is left over is dangling.
+  void ResolveLinks() {
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      for (Entry& entry : index_->entries_) {
+        if (entry.link != kUnresolvedLink)
+          continue;
+        uint32_t target = index_->Walk(base::StringPiece(
+            index_->strings_.data() + entry.link_offset, entry.link_length));
+        if (target != kInvalidEntry) {
+          entry.link = target;
+          progress = true;
+        }
+      }
+    }
+
+    for (Entry& entry : index_->entries_) {
+      if (entry.link == kUnresolvedLink)
+        entry.link = kInvalidEntry;
+      if (entry.flags & FLAG_LINK)
+        index_->has_links_ = true;
+    }
+  }
+
+  ArchiveIndex* index_;
+  uint32_t header_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(Builder);
+};
+
+ArchiveIndex::ArchiveIndex() : has_links_(false) {
+}
+
+ArchiveIndex::~ArchiveIndex() {
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::Create(
+    const base::DictionaryValue& header, uint32_t header_size) {
+  std::unique_ptr<ArchiveIndex> index(new ArchiveIndex);
+  Builder builder(index.get(), header_size);
+  builder.Build(header);
+
+  index->entries_.shrink_to_fit();
+  index->hashes_.shrink_to_fit();
+  index->strings_.shrink_to_fit();
+  return index;
+}
+
+uint32_t ArchiveIndex::Lookup(const base::StringPiece& path) const {
+  if (path.empty())
+    return kRootEntry;
+
+  // Empty components ("a//b", "a/", "/a") are resolved relative to the root
+  // by the walk, and never appear in the table.
+  bool needs_walk =
+      IsSeparator(path[0]) || IsSeparator(path[path.size() - 1]);
+  uint32_t hash = kFNVOffsetBasis;
+  for (size_t i = 0; i < path.size(); ++i) {
+    if (i > 0 && IsSeparator(path[i]) && IsSeparator(path[i - 1]))
+      needs_walk = true;
+    hash = HashChar(hash, path[i]);
+  }
+
+  const size_t mask = table_.size() - 1;
+  for (size_t slot = hash & mask; table_[slot] != kInvalidEntry;
+       slot = (slot + 1) & mask) {
+    uint32_t index = table_[slot];
+    if (hashes_[index] == hash && MatchesPath(index, path))
+      return index;
+  }
+
+  // Paths through linked directories are not in the table either.
+  if (!has_links_ && !needs_walk)
+    return kInvalidEntry;
+  return Walk(path);
+}
+
+uint32_t ArchiveIndex::ResolveLinks(uint32_t index) const {
+  for (int depth = 0; index != kInvalidEntry; ++depth) {
+    if (!(entries_[index].flags & FLAG_LINK))
+      return index;
+    if (depth == kMaxLinkDepth)
+      break;
+    index = entries_[index].link;
+  }
+  return kInvalidEntry;
+}
+
+uint32_t ArchiveIndex::GetDirectory(uint32_t index) const {
+  if (index == kInvalidEntry)
+    return kInvalidEntry;
+  if (entries_[index].flags & FLAG_LINK)
+    index = entries_[index].link;
+  if (index >= entries_.size() ||
+      !(entries_[index].flags & FLAG_DIRECTORY))
+    return kInvalidEntry;
+  return index;
+}
+
+base::StringPiece ArchiveIndex::GetName(uint32_t index) const {
+  const Entry& entry = entries_[index];
+  return base::StringPiece(strings_.data() + entry.name_offset,
+                           entry.name_length);
+}
+
+base::StringPiece ArchiveIndex::GetLinkPath(uint32_t index) const {
+  const Entry& entry = entries_[index];
+  return base::StringPiece(strings_.data() + entry.link_offset,
+                           entry.link_length);
+}
+
+size_t ArchiveIndex::GetMemoryUsage() const {
+  return entries_.capacity() * sizeof(Entry) +
+         hashes_.capacity() * sizeof(uint32_t) +
+         table_.capacity() * sizeof(uint32_t) +
+         strings_.capacity();
+}
+
+uint32_t ArchiveIndex::FindChild(uint32_t dir,
+                                 const base::StringPiece& name) const {
+  const Entry& entry = entries_[dir];
+  uint32_t begin = entry.first_child;
+  uint32_t end = begin + entry.child_count;
+  while (begin < end) {
+    uint32_t middle = begin + (end - begin) / 2;
+    int result = GetName(middle).compare(name);
+    if (result == 0)
+      return middle;
+    if (result < 0)
+      begin = middle + 1;
+    else
+      end = middle;
+  }
+  return kInvalidEntry;
+}
+
+uint32_t ArchiveIndex::Walk(const base::StringPiece& path) const {
+  if (path.empty())
+    return kRootEntry;
+
+  uint32_t current = kRootEntry;
+  size_t start = 0;
+  while (true) {
+    size_t end = start;
+    while (end < path.size() && !IsSeparator(path[end]))
+      ++end;
+
+    base::StringPiece name = path.substr(start, end - start);
+    if (name.empty()) {
+      current = kRootEntry;
+    } else {
+      uint32_t dir = GetDirectory(current);
+      if (dir == kInvalidEntry)
+        return kInvalidEntry;
+      current = FindChild(dir, name);
+      if (current == kInvalidEntry)
+        return kInvalidEntry;
+    }
+
+    if (end == path.size())
+      return current;
+    start = end + 1;
+  }
+}
+
+bool ArchiveIndex::MatchesPath(uint32_t index,
+                               const base::StringPiece& path) const {
+  size_t end = path.size();
+  while (index != kRootEntry) {
+    base::StringPiece name = GetName(index);
+    if (end < name.size())
+      return false;
+    size_t start = end - name.size();
+    if (path.substr(start, name.size()) != name)
+      return false;
+
+    index = entries_[index].parent;
+    if (index == kRootEntry)
+      return start == 0;
+    if (start == 0 || !IsSeparator(path[start - 1]))
+      return false;
+    end = start - 1;
+  }
+  return end == 0;
+}
+
+}  // namespace asar
@@ -0,0 +1,116 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
+#define ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace asar {
+
+// A flat, read-only index of an asar header.
+//
+// The JSON header is compiled once into a vector of entries laid out in
+// breadth-first order, so the children of every directory are contiguous and
+// sorted by name.  All names and link targets live in a single string table,
+// and an open-addressed hash table maps full relative paths to entries.
+// Lookups never allocate.
+class ArchiveIndex {
+ public:
+  static const uint32_t kInvalidEntry = 0xFFFFFFFF;
+  static const uint32_t kRootEntry = 0;
+
+  enum Flags : uint32_t {
+    FLAG_DIRECTORY = 1 << 0,
+    FLAG_LINK = 1 << 1,
+    FLAG_UNPACKED = 1 << 2,
+    FLAG_EXECUTABLE = 1 << 3,
+    // The stored bytes are a gzip stream of |compressed_size| bytes.
+    FLAG_COMPRESSED = 1 << 4,
+    // A file node without a usable size or offset. The rest of the archive
+    // stays readable, only this entry can not be read or stat'ed.
+    FLAG_INVALID = 1 << 5,
+  };
+
+  struct Entry {
+    uint32_t parent;
+    uint32_t flags;
+    uint32_t name_offset;
+    uint32_t name_length;
+    // Directories: children are [first_child, first_child + child_count).
+    uint32_t first_child;
+    uint32_t child_count;
+    // Links: the resolved target entry and the raw "link" string.
+    uint32_t link;
+    uint32_t link_offset;
+    uint32_t link_length;
+    // Files: uncompressed size, stored size and absolute offset into the
+    // archive.
+    uint32_t size;
+    uint32_t compressed_size;
+    uint64_t offset;
+  };
+
+  // Compiles |header|, adding |header_size| to every file offset.  Malformed
+  // file nodes are marked FLAG_INVALID instead of failing the whole header.
+  static std::unique_ptr<ArchiveIndex> Create(
+      const base::DictionaryValue& header, uint32_t header_size);
+
+  ~ArchiveIndex();
+
+  // Returns the entry at relative |path|, following links of intermediate
+  // directories but not of the final component.  Both '/' and, on Windows,
+  // '\\' are accepted as separators.
+  uint32_t Lookup(const base::StringPiece& path) const;
+
+  // Follows links starting at |index| until a non-link entry is reached.
+  uint32_t ResolveLinks(uint32_t index) const;
+
+  // Returns the directory whose children should be listed for |index|, which
+  // is |index| itself or the target of a linked directory.
+  uint32_t GetDirectory(uint32_t index) const;
+
+  const Entry& entry(uint32_t index) const { return entries_[index]; }
+  size_t size() const { return entries_.size(); }
+
+  base::StringPiece GetName(uint32_t index) const;
+  base::StringPiece GetLinkPath(uint32_t index) const;
+
+  // Approximate number of bytes held by the index.
+  size_t GetMemoryUsage() const;
+
+ private:
+  class Builder;
+
+  ArchiveIndex();
+
+  uint32_t FindChild(uint32_t dir, const base::StringPiece& name) const;
+  uint32_t Walk(const base::StringPiece& path) const;
+  bool MatchesPath(uint32_t index, const base::StringPiece& path) const;
+
+  std::vector<Entry> entries_;
+  // Hash of the full relative path of every entry, parallel to |entries_|.
+  std::vector<uint32_t> hashes_;
+  // Open-addressed table of entry indices, kInvalidEntry marks empty slots.
+  std::vector<uint32_t> table_;
+  std::string strings_;
+  bool has_links_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveIndex);
+};
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
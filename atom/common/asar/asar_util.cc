@@ -4,37 +4,178 @@
 
 #include "atom/common/asar/asar_util.h"
 
+#include <list>
 #include <map>
 #include <string>
+#include <utility>
 
 #include "atom/common/asar/archive.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/lazy_instance.h"
-#include "base/stl_util.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 
 namespace asar {
 
 namespace {
 
-// The global instance of ArchiveMap, will be destroyed on exit.
-typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
-static base::LazyInstance<ArchiveMap>::DestructorAtExit g_archive_map =
-    LAZY_INSTANCE_INITIALIZER;
-
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
-}  // namespace
+// Enough for the app's own archives plus a handful of extensions and
+// components that are touched once.
+const size_t kDefaultArchiveCacheCapacity = 32;
+
+// A process-wide LRU cache of opened archives. It is used from the UI, IO and
+// file threads as well as worker threads, so every access takes |lock_|.
+// Archives are opened outside of the lock, and evicted archives stay alive
+// until their last user releases them.
+class ArchiveCache {
+ public:
+  ArchiveCache() : capacity_(kDefaultArchiveCacheCapacity) {}
+
+  std::shared_ptr<Archive> Get(const base::FilePath& path) {
+    {
+      base::AutoLock auto_lock(lock_);
+      auto it = index_.find(path);
+      if (it != index_.end()) {
+        ++stats_.hits;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+      }
+      ++stats_.misses;
+    }
 
-std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  ArchiveMap& archive_map = *g_archive_map.Pointer();
-  if (!ContainsKey(archive_map, path)) {
     std::shared_ptr<Archive> archive(new Archive(path));
-    if (!archive->Init())
+    if (!archive->Init()) {
+      base::AutoLock auto_lock(lock_);
+      ++stats_.failures;
       return nullptr;
-    archive_map[path] = archive;
+    }
+    // Cached archives are long lived, so serve their packed files from a
+    // single mapping. Reads fall back to the file if mapping fails.
+    archive->MapFile();
+
+    base::AutoLock auto_lock(lock_);
+    // Another thread may have opened the same archive in the meantime, ours
+    // is then dropped and not counted.
+    auto it = index_.find(path);
+    if (it != index_.end())
+      return it->second->second;
+
+    ++stats_.opens;
+    entries_.push_front(std::make_pair(path, archive));
+    index_[path] = entries_.begin();
+    EvictIfNeeded();
+    return archive;
+  }
+
+  void SetCapacity(size_t capacity) {
+    base::AutoLock auto_lock(lock_);
+    capacity_ = capacity;
+    EvictIfNeeded();
+  }
+
+  ArchiveCacheStats GetStats() {
+    base::AutoLock auto_lock(lock_);
+    ArchiveCacheStats stats = stats_;
+    stats.size = entries_.size();
+    stats.capacity = capacity_;
+    return stats;
+  }
+
+ private:
+  typedef std::list<std::pair<base::FilePath, std::shared_ptr<Archive>>>
+      EntryList;
+
+  // Archives still referenced elsewhere, e.g. by the cache of asar.js, are
+  // skipped: evicting them frees nothing, and the next Get() would open a
+  // second copy with its own fd and mapping. The cache can stay above its
+  // capacity until they are released.
+  void EvictIfNeeded() {
+    lock_.AssertAcquired();
+    auto it = entries_.end();
+    while (capacity_ > 0 && entries_.size() > capacity_ &&
+           it != entries_.begin()) {
+      --it;
+      if (it->second.use_count() > 1)
+        continue;
+      index_.erase(it->first);
+      it = entries_.erase(it);
+      ++stats_.evictions;
+    }
+  }
+
+  base::Lock lock_;
+  // Most recently used first.
+  EntryList entries_;
+  std::map<base::FilePath, EntryList::iterator> index_;
+  size_t capacity_;
+  ArchiveCacheStats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveCache);
+};
+
+// The global instance of ArchiveCache, will be destroyed on exit.
+static base::LazyInstance<ArchiveCache>::DestructorAtExit g_archive_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// A packed file inside a mapped archive, which is kept alive with it.
+class MappedArchiveMemory : public base::RefCountedMemory {
+ public:
+  MappedArchiveMemory(std::shared_ptr<Archive> archive,
+                      const base::StringPiece& data)
+      : archive_(archive), data_(data) {}
+
+  const unsigned char* front() const override {
+    return reinterpret_cast<const unsigned char*>(data_.data());
+  }
+  size_t size() const override { return data_.size(); }
+
+ private:
+  ~MappedArchiveMemory() override {}
+
+  std::shared_ptr<Archive> archive_;
+  base::StringPiece data_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedArchiveMemory);
+};
+
+// Finds |path| either on disk, in which case |real_path| is set, or as a
+// packed file of |archive| described by |info|.
+bool LocateFile(const base::FilePath& path,
+                std::shared_ptr<Archive>* archive,
+                Archive::FileInfo* info,
+                base::FilePath* real_path) {
+  base::FilePath asar_path, relative_path;
+  if (!GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    *real_path = path;
+    return true;
   }
-  return archive_map[path];
+
+  *archive = GetOrCreateAsarArchive(asar_path);
+  if (!*archive || !(*archive)->GetFileInfo(relative_path, info))
+    return false;
+
+  // For unpacked file it will return the real path instead of doing the copy.
+  if (info->unpacked)
+    (*archive)->CopyFileOut(relative_path, real_path);
+  return true;
+}
+
+}  // namespace
+
+std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
+  return g_archive_cache.Get().Get(path);
+}
+
+void SetArchiveCacheCapacity(size_t capacity) {
+  g_archive_cache.Get().SetCapacity(capacity);
+}
+
+ArchiveCacheStats GetArchiveCacheStats() {
+  return g_archive_cache.Get().GetStats();
 }
 
 bool GetAsarArchivePath(const base::FilePath& full_path,
@@ -59,33 +200,53 @@ bool GetAsarArchivePath(const base::FilePath& full_path,
   return true;
 }
 
-bool ReadFileToString(const base::FilePath& path, std::string* contents) {
+bool IsFile(const base::FilePath& path) {
   base::FilePath asar_path, relative_path;
-  if (!GetAsarArchivePath(path, &asar_path, &relative_path))
-    return base::ReadFileToString(path, contents);
+  if (!GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    base::File::Info info;
+    return base::GetFileInfo(path, &info) && !info.is_directory;
+  }
 
   std::shared_ptr<Archive> archive = GetOrCreateAsarArchive(asar_path);
-  if (!archive)
-    return false;
+  Archive::FileInfo info;
+  return archive && archive->GetFileInfo(relative_path, &info);
+}
 
+bool ReadFileToString(const base::FilePath& path, std::string* contents) {
+  std::shared_ptr<Archive> archive;
   Archive::FileInfo info;
-  if (!archive->GetFileInfo(relative_path, &info))
+  base::FilePath real_path;
+  if (!LocateFile(path, &archive, &info, &real_path))
     return false;
 
-  if (info.unpacked) {
-    base::FilePath real_path;
-    // For unpacked file it will return the real path instead of doing the copy.
-    archive->CopyFileOut(relative_path, &real_path);
+  if (!real_path.empty())
     return base::ReadFileToString(real_path, contents);
+  return archive->ReadFile(info, contents);
+}
+
+scoped_refptr<base::RefCountedMemory> ReadFileToMemory(
+    const base::FilePath& path) {
+  std::shared_ptr<Archive> archive;
+  Archive::FileInfo info;
+  base::FilePath real_path;
+  if (!LocateFile(path, &archive, &info, &real_path))
+    return nullptr;
+
+  std::string contents;
+  if (!real_path.empty()) {
+    if (!base::ReadFileToString(real_path, &contents))
+      return nullptr;
+    return base::RefCountedString::TakeString(&contents);
   }
 
-  base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
-  if (!src.IsValid())
-    return false;
+  base::StringPiece data;
+  if (!info.compressed &&
+      archive->GetMappedData(info.offset, info.size, &data))
+    return new MappedArchiveMemory(archive, data);
 
-  contents->resize(info.size);
-  return static_cast<int>(info.size) == src.Read(
-      info.offset, const_cast<char*>(contents->data()), contents->size());
+  if (!archive->ReadFile(info, &contents))
+    return nullptr;
+  return base::RefCountedString::TakeString(&contents);
 }
 
 }  // namespace asar
@@ -5,28 +5,63 @@
 #ifndef ATOM_COMMON_ASAR_ASAR_UTIL_H_
 #define ATOM_COMMON_ASAR_ASAR_UTIL_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
+#include "base/memory/ref_counted.h"
+
 namespace base {
 class FilePath;
+class RefCountedMemory;
 }
 
 namespace asar {
 
 class Archive;
 
-// Gets or creates a new Archive from the path.
+struct ArchiveCacheStats {
+  ArchiveCacheStats()
+      : hits(0), misses(0), opens(0), failures(0), evictions(0), size(0),
+        capacity(0) {}
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t opens;
+  uint64_t failures;
+  uint64_t evictions;
+  size_t size;
+  size_t capacity;
+};
+
+// Gets or creates a new Archive from the path. Safe to call from any thread.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
+// Sets how many archives are kept open, least recently used ones are evicted
+// first. Archives that are still in use are not evicted. 0 means unbounded.
+void SetArchiveCacheCapacity(size_t capacity);
+
+// Returns the counters of the archive cache.
+ArchiveCacheStats GetArchiveCacheStats();
+
 // Separates the path to Archive out.
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
                         base::FilePath* relative_path);
 
+// Returns true if |path| is a file, inside an asar Archive or not. Nothing
+// is read and no unpacked file is copied out.
+bool IsFile(const base::FilePath& path);
+
 // Same with base::ReadFileToString but supports asar Archive.
 bool ReadFileToString(const base::FilePath& path, std::string* contents);
 
+// Like ReadFileToString, but packed files of a mapped archive are returned as
+// a view into the mapping instead of a copy. Returns nullptr on failure.
+scoped_refptr<base::RefCountedMemory> ReadFileToMemory(
+    const base::FilePath& path);
+
 }  // namespace asar
 
 #endif  // ATOM_COMMON_ASAR_ASAR_UTIL_H_
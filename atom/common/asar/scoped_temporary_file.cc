@@ -71,4 +71,17 @@ bool ScopedTemporaryFile::InitFromFile(base::File* src,
       static_cast<int>(size);
 }
 
+bool ScopedTemporaryFile::InitFromData(const base::FilePath::StringType& ext,
+                                       const base::StringPiece& data) {
+  if (!Init(ext))
+    return false;
+
+  base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  if (!dest.IsValid())
+    return false;
+
+  return dest.WriteAtCurrentPos(data.data(), data.size()) ==
+      static_cast<int>(data.size());
+}
+
 }  // namespace asar
@@ -0,0 +1,162 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/content_settings_delta.h"
+
+#include <utility>
+
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+bool IsSameValue(const base::ListValue& a, size_t a_index,
+                 const base::ListValue& b, size_t b_index) {
+  const base::Value* a_value = nullptr;
+  const base::Value* b_value = nullptr;
+  return a.Get(a_index, &a_value) && b.Get(b_index, &b_value) &&
+         a_value->Equals(b_value);
+}
+
+}  // namespace
+
+// Rule lists of a content type usually change in one place, so each changed
+// type becomes a single splice replacing the range between the common prefix
+// and the common suffix.
+bool DiffContentSettings(const base::DictionaryValue& old_settings,
+                         const base::DictionaryValue& new_settings,
+                         base::ListValue* splices) {
+  for (base::DictionaryValue::Iterator it(new_settings); !it.IsAtEnd();
+       it.Advance()) {
+    const base::ListValue* new_rules = nullptr;
+    if (!it.value().GetAsList(&new_rules))
+      return false;
+
+    const base::ListValue* old_rules = nullptr;
+    size_t old_size = 0;
+    if (old_settings.HasKey(it.key())) {
+      if (!old_settings.GetListWithoutPathExpansion(it.key(), &old_rules))
+        return false;
+      old_size = old_rules->GetSize();
+    }
+    size_t new_size = new_rules->GetSize();
+
+    size_t prefix = 0;
+    while (old_rules && prefix < old_size && prefix < new_size &&
+           IsSameValue(*old_rules, prefix, *new_rules, prefix))
+      ++prefix;
+    if (old_rules && prefix == old_size && prefix == new_size)
+      continue;
+
+    size_t suffix = 0;
+    while (old_rules && suffix < old_size - prefix &&
+           suffix < new_size - prefix &&
+           IsSameValue(*old_rules, old_size - suffix - 1,
+                       *new_rules, new_size - suffix - 1))
+      ++suffix;
+
+    std::unique_ptr<base::DictionaryValue> splice(new base::DictionaryValue);
+    std::unique_ptr<base::ListValue> rules(new base::ListValue);
+    for (size_t i = prefix; i < new_size - suffix; ++i) {
+      const base::Value* rule = nullptr;
+      new_rules->Get(i, &rule);
+      rules->Append(rule->CreateDeepCopy());
+    }
+    splice->SetString("type", it.key());
+    splice->SetInteger("start", static_cast<int>(prefix));
+    splice->SetInteger("deleteCount",
+                       static_cast<int>(old_size - prefix - suffix));
+    splice->Set("rules", std::move(rules));
+    splices->Append(std::move(splice));
+  }
+
+  for (base::DictionaryValue::Iterator it(old_settings); !it.IsAtEnd();
+       it.Advance()) {
+    if (new_settings.HasKey(it.key()))
+      continue;
+    std::unique_ptr<base::DictionaryValue> splice(new base::DictionaryValue);
+    splice->SetString("type", it.key());
+    splice->SetBoolean("remove", true);
+    splices->Append(std::move(splice));
+  }
+  return true;
+}
+
+VersionedContentSettings::VersionedContentSettings() : version_(-1) {
+}
+
+VersionedContentSettings::~VersionedContentSettings() {
+}
+
+void VersionedContentSettings::Reset(int version,
+                                     const base::DictionaryValue& settings) {
+  settings_ = settings.CreateDeepCopy();
+  version_ = version;
+}
+
+bool VersionedContentSettings::ApplyDelta(
+    int base_version,
+    int version,
+    const base::ListValue& splices,
+    std::set<std::string>* changed_types) {
+  if (!settings_ || version_ < 0 || base_version != version_)
+    return false;
+
+  // A splice that does not fit may leave the earlier ones applied, so the
+  // settings can only be trusted again after a full update.
+  version_ = -1;
+  if (!ApplySplices(splices, changed_types))
+    return false;
+  version_ = version;
+  return true;
+}
+
+bool VersionedContentSettings::ApplySplices(
+    const base::ListValue& splices,
+    std::set<std::string>* changed_types) {
+  for (size_t i = 0; i < splices.GetSize(); ++i) {
+    const base::DictionaryValue* splice = nullptr;
+    std::string type;
+    if (!splices.GetDictionary(i, &splice) ||
+        !splice->GetString("type", &type))
+      return false;
+    changed_types->insert(type);
+
+    bool remove = false;
+    if (splice->GetBoolean("remove", &remove) && remove) {
+      settings_->RemoveWithoutPathExpansion(type, nullptr);
+      continue;
+    }
+
+    base::ListValue* rules = nullptr;
+    if (!settings_->GetListWithoutPathExpansion(type, &rules)) {
+      rules = new base::ListValue;
+      settings_->SetWithoutPathExpansion(
+          type, std::unique_ptr<base::Value>(rules));
+    }
+
+    int start = 0;
+    int delete_count = 0;
+    if (!splice->GetInteger("start", &start) ||
+        !splice->GetInteger("deleteCount", &delete_count) ||
+        start < 0 || delete_count < 0 ||
+        static_cast<size_t>(start) + delete_count > rules->GetSize())
+      return false;
+
+    for (int j = 0; j < delete_count; ++j)
+      rules->Remove(start, nullptr);
+    const base::ListValue* inserted = nullptr;
+    if (splice->GetList("rules", &inserted)) {
+      for (size_t j = 0; j < inserted->GetSize(); ++j) {
+        const base::Value* rule = nullptr;
+        inserted->Get(j, &rule);
+        rules->Insert(start + j, rule->CreateDeepCopy());
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace atom
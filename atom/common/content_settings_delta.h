@@ -0,0 +1,64 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_CONTENT_SETTINGS_DELTA_H_
+#define ATOM_COMMON_CONTENT_SETTINGS_DELTA_H_
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/macros.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace atom {
+
+// Appends to |splices| the edits that turn the rules of |old_settings| into
+// those of |new_settings|, both being dictionaries of rule lists keyed by
+// content type. Returns false if a content type is not a list of rules.
+bool DiffContentSettings(const base::DictionaryValue& old_settings,
+                         const base::DictionaryValue& new_settings,
+                         base::ListValue* splices);
+
+// The content settings a renderer was last sent by the browser, kept up to
+// date with the deltas that follow.
+class VersionedContentSettings {
+ public:
+  VersionedContentSettings();
+  ~VersionedContentSettings();
+
+  void Reset(int version, const base::DictionaryValue& settings);
+
+  // Applies the |splices| from |base_version| to |version|, adding the
+  // content types they change to |changed_types|. Returns false if the
+  // settings are not at |base_version| or the splices do not fit them, in
+  // which case only a full update can bring them up to date and every delta
+  // is refused until then.
+  bool ApplyDelta(int base_version,
+                  int version,
+                  const base::ListValue& splices,
+                  std::set<std::string>* changed_types);
+
+  // Null before the first full update.
+  const base::DictionaryValue* settings() const { return settings_.get(); }
+  int version() const { return version_; }
+
+ private:
+  bool ApplySplices(const base::ListValue& splices,
+                    std::set<std::string>* changed_types);
+
+  std::unique_ptr<base::DictionaryValue> settings_;
+  // -1 while a full update is needed.
+  int version_;
+
+  DISALLOW_COPY_AND_ASSIGN(VersionedContentSettings);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_CONTENT_SETTINGS_DELTA_H_
@@ -0,0 +1,150 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/content_settings_delta.h"
+
+#include <initializer_list>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace atom {
+
+namespace {
+
+std::unique_ptr<base::ListValue> MakeRules(
+    std::initializer_list<const char*> patterns) {
+  std::unique_ptr<base::ListValue> rules(new base::ListValue);
+  for (const char* pattern : patterns) {
+    std::unique_ptr<base::DictionaryValue> rule(new base::DictionaryValue);
+    rule->SetString("primaryPattern", pattern);
+    rule->SetString("setting", "block");
+    rules->Append(std::move(rule));
+  }
+  return rules;
+}
+
+std::unique_ptr<base::DictionaryValue> MakeSplice(const std::string& type,
+                                                  int start,
+                                                  int delete_count) {
+  std::unique_ptr<base::DictionaryValue> splice(new base::DictionaryValue);
+  splice->SetString("type", type);
+  splice->SetInteger("start", start);
+  splice->SetInteger("deleteCount", delete_count);
+  return splice;
+}
+
+}  // namespace
+
+TEST(ContentSettingsDeltaTest, DiffAppliesToOldSettings) {
+  base::DictionaryValue old_settings;
+  old_settings.Set("images", MakeRules({"a.com", "b.com", "c.com"}));
+  old_settings.Set("plugins", MakeRules({"a.com"}));
+  old_settings.Set("cookies", MakeRules({"a.com"}));
+
+  base::DictionaryValue new_settings;
+  new_settings.Set("images", MakeRules({"a.com", "x.com", "y.com", "c.com"}));
+  new_settings.Set("plugins", MakeRules({"a.com"}));
+  new_settings.Set("javascript", MakeRules({"b.com"}));
+
+  base::ListValue splices;
+  ASSERT_TRUE(DiffContentSettings(old_settings, new_settings, &splices));
+  // Unchanged types are left out.
+  EXPECT_EQ(3u, splices.GetSize());
+
+  VersionedContentSettings settings;
+  settings.Reset(1, old_settings);
+  std::set<std::string> changed_types;
+  ASSERT_TRUE(settings.ApplyDelta(1, 2, splices, &changed_types));
+  EXPECT_EQ(2, settings.version());
+  EXPECT_TRUE(settings.settings()->Equals(&new_settings));
+  EXPECT_EQ((std::set<std::string>{"images", "javascript", "cookies"}),
+            changed_types);
+}
+
+TEST(ContentSettingsDeltaTest, NoDiffForSameSettings) {
+  base::DictionaryValue settings;
+  settings.Set("images", MakeRules({"a.com", "b.com"}));
+
+  base::ListValue splices;
+  ASSERT_TRUE(DiffContentSettings(settings, settings, &splices));
+  EXPECT_TRUE(splices.empty());
+}
+
+TEST(ContentSettingsDeltaTest, DiffRejectsNonListTypes) {
+  base::DictionaryValue old_settings;
+  base::DictionaryValue new_settings;
+  new_settings.SetString("images", "block");
+
+  base::ListValue splices;
+  EXPECT_FALSE(DiffContentSettings(old_settings, new_settings, &splices));
+}
+
+TEST(ContentSettingsDeltaTest, RefusesVersionMismatch) {
+  base::DictionaryValue initial;
+  initial.Set("images", MakeRules({"a.com"}));
+
+  VersionedContentSettings settings;
+  base::ListValue splices;
+  splices.Append(MakeSplice("images", 0, 1));
+  std::set<std::string> changed_types;
+
+  // Nothing to apply a delta to before the first full update.
+  EXPECT_FALSE(settings.ApplyDelta(0, 1, splices, &changed_types));
+
+  settings.Reset(3, initial);
+  EXPECT_FALSE(settings.ApplyDelta(2, 4, splices, &changed_types));
+  // A refused delta leaves the settings untouched.
+  EXPECT_EQ(3, settings.version());
+  EXPECT_TRUE(settings.settings()->Equals(&initial));
+  EXPECT_TRUE(changed_types.empty());
+}
+
+TEST(ContentSettingsDeltaTest, BadSpliceNeedsFullUpdate) {
+  base::DictionaryValue initial;
+  initial.Set("images", MakeRules({"a.com"}));
+
+  VersionedContentSettings settings;
+  settings.Reset(1, initial);
+
+  base::ListValue splices;
+  splices.Append(MakeSplice("images", 1, 1));
+  std::set<std::string> changed_types;
+  EXPECT_FALSE(settings.ApplyDelta(1, 2, splices, &changed_types));
+
+  // Later deltas are refused until the next full update.
+  base::ListValue next;
+  next.Append(MakeSplice("images", 0, 0));
+  EXPECT_FALSE(settings.ApplyDelta(2, 3, next, &changed_types));
+  EXPECT_FALSE(settings.ApplyDelta(1, 3, next, &changed_types));
+
+  settings.Reset(3, initial);
+  EXPECT_TRUE(settings.ApplyDelta(3, 4, next, &changed_types));
+  EXPECT_EQ(4, settings.version());
+}
+
+TEST(ContentSettingsDeltaTest, RemovesTypes) {
+  base::DictionaryValue initial;
+  initial.Set("images", MakeRules({"a.com"}));
+
+  VersionedContentSettings settings;
+  settings.Reset(1, initial);
+
+  base::ListValue splices;
+  std::unique_ptr<base::DictionaryValue> splice(new base::DictionaryValue);
+  splice->SetString("type", "images");
+  splice->SetBoolean("remove", true);
+  splices.Append(std::move(splice));
+
+  std::set<std::string> changed_types;
+  ASSERT_TRUE(settings.ApplyDelta(1, 2, splices, &changed_types));
+  EXPECT_FALSE(settings.settings()->HasKey("images"));
+  EXPECT_EQ(1u, changed_types.count("images"));
+}
+
+}  // namespace atom
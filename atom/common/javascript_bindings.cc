@@ -4,6 +4,7 @@
 
 #include "atom/common/javascript_bindings.h"
 
+#include <utility>
 #include <vector>
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_api_key_weak_map.h"
@@ -15,6 +16,7 @@
 #include "base/memory/shared_memory.h"
 #include "base/memory/shared_memory_handle.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
+#include "brave/common/serialized_args.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_view.h"
 #include "extensions/renderer/console.h"
@@ -129,12 +131,30 @@ void JavascriptBindings::DeleteHiddenValue(v8::Isolate* isolate,
 
 void JavascriptBindings::IPCSend(mate::Arguments* args,
           const base::string16& channel,
-          const base::ListValue& arguments) {
+          v8::Local<v8::Value> arguments) {
   if (!is_valid() || !render_view())
     return;
 
+  AtomMsg_SerializedArgs serialized;
+  if (brave::SerializeArgs(args->isolate(), arguments, &serialized)) {
+    bool success = render_view()->Send(new AtomViewHostMsg_Message_Serialized(
+        render_view()->GetRoutingID(), channel, serialized));
+
+    if (!success)
+      args->ThrowError("Unable to send AtomViewHostMsg_Message_Serialized");
+    return;
+  }
+
+  // Arguments that can not be cloned, like functions, are still converted
+  // the old way.
+  base::ListValue list;
+  if (!mate::ConvertFromV8(args->isolate(), arguments, &list)) {
+    args->ThrowError("Unable to convert arguments");
+    return;
+  }
+
   bool success = render_view()->Send(new AtomViewHostMsg_Message(
-      render_view()->GetRoutingID(), channel, arguments));
+      render_view()->GetRoutingID(), channel, list));
 
   if (!success)
     args->ThrowError("Unable to send AtomViewHostMsg_Message");
@@ -142,40 +162,58 @@ void JavascriptBindings::IPCSend(mate::Arguments* args,
 
 void JavascriptBindings::IPCSendShared(mate::Arguments* args,
             const base::string16& channel,
-            base::SharedMemory* shared_memory) {
+            brave::SharedMemoryWrapper* shared) {
   if (!is_valid() || !render_view())
     return;
 
-  base::SharedMemoryHandle memory_handle = shared_memory->handle().Duplicate();
-  if (!memory_handle.IsValid()) {
+  AtomMsg_SharedSegment segment;
+  if (!shared || !shared->Share(&segment)) {
     args->ThrowError("Could not create shared memory handle");
     return;
   }
 
   bool success = Send(new AtomViewHostMsg_Message_Shared(
-      render_view()->GetRoutingID(), channel, memory_handle));
+      render_view()->GetRoutingID(), channel, segment));
 
   if (!success)
     args->ThrowError("Unable to send AtomViewHostMsg_Message_Shared");
 }
 
-base::string16 JavascriptBindings::IPCSendSync(mate::Arguments* args,
-                        const base::string16& channel,
-                        const base::ListValue& arguments) {
-  base::string16 json;
-
-  if (!is_valid() || !render_view()) {
-    return json;
+v8::Local<v8::Value> JavascriptBindings::IPCSendSync(
+    mate::Arguments* args,
+    const base::string16& channel,
+    v8::Local<v8::Value> arguments) {
+  v8::Isolate* isolate = args->isolate();
+  if (!is_valid() || !render_view())
+    return v8::Undefined(isolate);
+
+  AtomMsg_SerializedArgs serialized;
+  AtomMsg_SerializedArgs result;
+  IPC::SyncMessage* message;
+  if (brave::SerializeArgs(isolate, arguments, &serialized)) {
+    message = new AtomViewHostMsg_Message_Sync_Serialized(
+        render_view()->GetRoutingID(), channel, serialized, &result);
+  } else {
+    // Arguments that can not be cloned, like functions, are still converted
+    // the old way.
+    base::ListValue list;
+    if (!mate::ConvertFromV8(isolate, arguments, &list)) {
+      args->ThrowError("Unable to convert arguments");
+      return v8::Undefined(isolate);
+    }
+    message = new AtomViewHostMsg_Message_Sync(
+        render_view()->GetRoutingID(), channel, list, &result);
   }
 
-  IPC::SyncMessage* message = new AtomViewHostMsg_Message_Sync(
-      render_view()->GetRoutingID(), channel, arguments, &json);
-  bool success = render_view()->Send(message);
-
-  if (!success)
+  if (!render_view()->Send(message)) {
     args->ThrowError("Unable to send AtomViewHostMsg_Message_Sync");
+    return v8::Undefined(isolate);
+  }
 
-  return json;
+  v8::Local<v8::Value> value;
+  if (!brave::DeserializeArgs(isolate, result, false).ToLocal(&value))
+    return v8::Undefined(isolate);
+  return value;
 }
 
 void JavascriptBindings::GetBinding(
@@ -241,6 +279,8 @@ bool JavascriptBindings::OnMessageReceived(const IPC::Message& message) {
   bool handled = false;  // don't swallow any of these messages
   IPC_BEGIN_MESSAGE_MAP(JavascriptBindings, message)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_Message_Serialized,
+                        OnSerializedBrowserMessage)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -248,7 +288,7 @@ bool JavascriptBindings::OnMessageReceived(const IPC::Message& message) {
 }
 
 void JavascriptBindings::OnSharedBrowserMessage(const base::string16& channel,
-                                      const base::SharedMemoryHandle& handle) {
+                                      const AtomMsg_SharedSegment& segment) {
   if (!is_valid())
     return;
 
@@ -258,7 +298,7 @@ void JavascriptBindings::OnSharedBrowserMessage(const base::string16& channel,
 
   std::vector<v8::Local<v8::Value>> args_vector;
   args_vector.insert(args_vector.begin(),
-      brave::SharedMemoryWrapper::CreateFrom(isolate, handle).ToV8());
+      brave::SharedMemoryWrapper::CreateFrom(isolate, segment).ToV8());
 
   // Insert the Event object, event.sender is ipc
   mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
@@ -286,7 +326,33 @@ void JavascriptBindings::OnBrowserMessage(bool all_frames,
   v8::HandleScope handle_scope(isolate);
   v8::Context::Scope context_scope(context()->v8_context());
 
-  auto args_vector = ListValueToVector(isolate, args);
+  EmitBrowserMessage(channel, ListValueToVector(isolate, args));
+}
+
+void JavascriptBindings::OnSerializedBrowserMessage(
+    bool all_frames,
+    const base::string16& channel,
+    const AtomMsg_SerializedArgs& args) {
+  if (!is_valid())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context()->v8_context());
+
+  v8::Local<v8::Value> value;
+  std::vector<v8::Local<v8::Value>> args_vector;
+  if (!brave::DeserializeArgs(isolate, args, false).ToLocal(&value) ||
+      !mate::ConvertFromV8(isolate, value, &args_vector))
+    return;
+
+  EmitBrowserMessage(channel, std::move(args_vector));
+}
+
+void JavascriptBindings::EmitBrowserMessage(
+    const base::string16& channel,
+    std::vector<v8::Local<v8::Value>> args_vector) {
+  v8::Isolate* isolate = context()->isolate();
 
   // Insert the Event object, event.sender is ipc
   mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
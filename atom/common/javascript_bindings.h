@@ -5,14 +5,18 @@
 #ifndef ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 #define ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 
+#include <vector>
+
 #include "content/public/renderer/render_view_observer.h"
 #include "extensions/renderer/object_backed_native_handler.h"
 #include "extensions/renderer/script_context.h"
 #include "v8/include/v8.h"
 
-namespace base {
-class SharedMemory;
-class SharedMemoryHandle;
+struct AtomMsg_SerializedArgs;
+struct AtomMsg_SharedSegment;
+
+namespace brave {
+class SharedMemoryWrapper;
 }
 
 namespace mate {
@@ -33,13 +37,13 @@ class JavascriptBindings : public content::RenderViewObserver,
  private:
   void IPCSendShared(mate::Arguments* args,
             const base::string16& channel,
-            base::SharedMemory* shared_memory);
-  base::string16 IPCSendSync(mate::Arguments* args,
-                        const base::string16& channel,
-                        const base::ListValue& arguments);
+            brave::SharedMemoryWrapper* shared);
+  v8::Local<v8::Value> IPCSendSync(mate::Arguments* args,
+                                   const base::string16& channel,
+                                   v8::Local<v8::Value> arguments);
   void IPCSend(mate::Arguments* args,
                         const base::string16& channel,
-                        const base::ListValue& arguments);
+                        v8::Local<v8::Value> arguments);
   v8::Local<v8::Value> GetHiddenValue(v8::Isolate* isolate,
                                     v8::Local<v8::String> key);
   void SetHiddenValue(v8::Isolate* isolate,
@@ -68,7 +72,12 @@ class JavascriptBindings : public content::RenderViewObserver,
                         const base::string16& channel,
                         const base::ListValue& args);
   void OnSharedBrowserMessage(const base::string16& channel,
-                              const base::SharedMemoryHandle& handle);
+                              const AtomMsg_SharedSegment& segment);
+  void OnSerializedBrowserMessage(bool all_frames,
+                                  const base::string16& channel,
+                                  const AtomMsg_SerializedArgs& args);
+  void EmitBrowserMessage(const base::string16& channel,
+                          std::vector<v8::Local<v8::Value>> args);
 
   DISALLOW_COPY_AND_ASSIGN(JavascriptBindings);
 };
@@ -2,6 +2,7 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "base/command_line.h"
 #include "base/environment.h"
 #include "base/files/file_path.h"
+#include "base/lazy_instance.h"
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
 #include "content/public/browser/browser_thread.h"
@@ -98,6 +100,13 @@ namespace atom {
 
 namespace {
 
+// How long the main thread keeps running the uv loop while events are ready
+// before giving the message loop a turn.
+const int kMaxUvRunSliceMs = 4;
+
+base::LazyInstance<UvLoopStats>::Leaky g_uv_loop_stats =
+    LAZY_INSTANCE_INITIALIZER;
+
 // Convert the given vector to an array of C-strings. The strings in the
 // returned vector are only guaranteed valid so long as the vector of strings
 // is not modified.
@@ -127,6 +136,10 @@ base::FilePath GetResourcesPath() {
 
 }  // namespace
 
+UvLoopStats GetUvLoopStats() {
+  return g_uv_loop_stats.Get();
+}
+
 NodeBindings::NodeBindings()
     : message_loop_(nullptr),
       uv_loop_(uv_default_loop()),
@@ -257,12 +270,29 @@ void NodeBindings::UvRunOnce() {
   // Enter node context while dealing with uv events.
   v8::Context::Scope context_scope(env->context());
 
-  // Perform microtask checkpoint after running JavaScript.
-  v8::MicrotasksScope script_scope(env->isolate(),
-                                   v8::MicrotasksScope::kRunMicrotasks);
+  UvLoopStats& stats = g_uv_loop_stats.Get();
+  base::TimeTicks start = base::TimeTicks::Now();
+  base::TimeTicks deadline =
+      start + base::TimeDelta::FromMilliseconds(kMaxUvRunSliceMs);
+  if (!wakeup_time_.is_null()) {
+    base::TimeDelta latency = start - wakeup_time_;
+    stats.wakeups++;
+    stats.total_latency += latency;
+    stats.max_latency = std::max(stats.max_latency, latency);
+    wakeup_time_ = base::TimeTicks();
+  }
+
+  // Deal with uv events. Events that are already waiting are handled right
+  // away, instead of each costing a round trip through the embed thread.
+  int r;
+  do {
+    // Perform microtask checkpoint after running JavaScript.
+    v8::MicrotasksScope script_scope(env->isolate(),
+                                     v8::MicrotasksScope::kRunMicrotasks);
+    r = uv_run(uv_loop_, UV_RUN_NOWAIT);
+    stats.iterations++;
+  } while (r != 0 && base::TimeTicks::Now() < deadline && HasPendingEvents());
 
-  // Deal with uv events.
-  int r = uv_run(uv_loop_, UV_RUN_NOWAIT);
   if (r == 0)
     message_loop_->QuitWhenIdle();  // Quit from uv.
 
@@ -270,6 +300,10 @@ void NodeBindings::UvRunOnce() {
   uv_sem_post(&embed_sem_);
 }
 
+bool NodeBindings::HasPendingEvents() {
+  return uv_backend_timeout(uv_loop_) == 0;
+}
+
 void NodeBindings::WakeupMainThread() {
   DCHECK(message_loop_);
   message_loop_->task_runner()->PostTask(
@@ -302,6 +336,7 @@ void NodeBindings::EmbedThreadRunner(void *arg) {
       break;
 
     // Deal with event in main thread.
+    self->wakeup_time_ = base::TimeTicks::Now();
     self->WakeupMainThread();
   }
 }
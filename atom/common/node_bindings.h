@@ -5,8 +5,11 @@
 #ifndef ATOM_COMMON_NODE_BINDINGS_H_
 #define ATOM_COMMON_NODE_BINDINGS_H_
 
+#include <stdint.h>
+
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
@@ -20,6 +23,22 @@ class Environment;
 
 namespace atom {
 
+struct UvLoopStats {
+  UvLoopStats() : wakeups(0), iterations(0) {}
+  // Times the embed thread woke the main thread up to run uv.
+  uint64_t wakeups;
+  // Runs of the uv loop, more than one per wakeup when events kept coming.
+  uint64_t iterations;
+  // Time from the embed thread seeing an event to the main thread running
+  // the uv loop.
+  base::TimeDelta total_latency;
+  base::TimeDelta max_latency;
+};
+
+// Returns the counters of the uv loop integration. Only the browser process
+// integrates the uv loop into its message loop.
+UvLoopStats GetUvLoopStats();
+
 class NodeBindings {
  public:
   static NodeBindings* Create();
@@ -51,9 +70,15 @@ class NodeBindings {
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
-  // Run the libuv loop for once.
+  // Run the libuv loop for once, and again while events are ready for a
+  // bounded time.
   void UvRunOnce();
 
+  // Returns true if the uv loop has events to deal with right away. Derived
+  // classes whose backend can be polled without consuming events also check
+  // it for ready I/O.
+  virtual bool HasPendingEvents();
+
   // Make the main thread run libuv loop.
   void WakeupMainThread();
 
@@ -82,6 +107,9 @@ class NodeBindings {
   // Semaphore to wait for main loop in the embed thread.
   uv_sem_t embed_sem_;
 
+  // When the embed thread last woke up the main thread.
+  base::TimeTicks wakeup_time_;
+
   // Environment that to wrap the uv loop.
   node::Environment* uv_env_;
 
@@ -49,6 +49,18 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsLinux::HasPendingEvents() {
+  if (NodeBindings::HasPendingEvents())
+    return true;
+
+  struct epoll_event ev;
+  int r;
+  do {
+    r = epoll_wait(epoll_, &ev, 1, 0);
+  } while (r == -1 && errno == EINTR);
+  return r > 0;
+}
+
 // static
 NodeBindings* NodeBindings::Create() {
   return new NodeBindingsLinux();
@@ -59,6 +59,23 @@ void NodeBindingsMac::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsMac::HasPendingEvents() {
+  if (NodeBindings::HasPendingEvents())
+    return true;
+
+  struct timeval tv = { 0, 0 };
+  fd_set readset;
+  int fd = uv_backend_fd(uv_loop_);
+  FD_ZERO(&readset);
+  FD_SET(fd, &readset);
+
+  int r;
+  do {
+    r = select(fd + 1, &readset, nullptr, nullptr, &tv);
+  } while (r == -1 && errno == EINTR);
+  return r > 0;
+}
+
 // static
 NodeBindings* NodeBindings::Create() {
   return new NodeBindingsMac();
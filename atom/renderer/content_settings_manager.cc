@@ -4,11 +4,12 @@
 
 #include "atom/renderer/content_settings_manager.h"
 
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include "atom/common/api/api_messages.h"
 #include "base/values.h"
-#include "components/content_settings/core/common/content_settings_pattern.h"
 #include "content/public/common/url_constants.h"
 #include "content/public/renderer/render_thread.h"
 #include "url/gurl.h"
@@ -16,7 +17,8 @@
 
 namespace atom {
 
-ContentSettingsManager::ContentSettingsManager() {
+ContentSettingsManager::ContentSettingsManager()
+    : resync_requested_(false) {
   content::RenderThread::Get()->AddObserver(this);
 }
 
@@ -37,6 +39,8 @@ bool ContentSettingsManager::OnControlMessageReceived(
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(ContentSettingsManager, message)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettings, OnUpdateContentSettings)
+    IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettingsDelta,
+                        OnUpdateContentSettingsDelta)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateWebKitPrefs, OnUpdateWebKitPrefs)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
@@ -49,8 +53,45 @@ void ContentSettingsManager::OnUpdateWebKitPrefs(
 }
 
 void ContentSettingsManager::OnUpdateContentSettings(
+    int version,
     const base::DictionaryValue& content_settings) {
-  content_settings_ = content_settings.CreateDeepCopy();
+  content_settings_.Reset(version, content_settings);
+  resync_requested_ = false;
+
+  rules_.clear();
+  for (base::DictionaryValue::Iterator it(content_settings); !it.IsAtEnd();
+       it.Advance()) {
+    const base::ListValue* rules = nullptr;
+    if (it.value().GetAsList(&rules))
+      rules_[it.key()] = ContentSettingsRules::Create(*rules);
+  }
+}
+
+void ContentSettingsManager::OnUpdateContentSettingsDelta(
+    int base_version,
+    int version,
+    const base::ListValue& splices) {
+  std::set<std::string> changed_types;
+  if (!content_settings_.ApplyDelta(base_version, version, splices,
+                                    &changed_types)) {
+    // The rules compiled so far stay in use until the full settings arrive.
+    if (!resync_requested_) {
+      resync_requested_ = true;
+      content::RenderThread::Get()->Send(
+          new AtomHostMsg_RequestContentSettings);
+    }
+    return;
+  }
+
+  // Only the changed content types are compiled again.
+  for (const std::string& type : changed_types) {
+    const base::ListValue* rules = nullptr;
+    if (content_settings_.settings()->GetListWithoutPathExpansion(type,
+                                                                  &rules))
+      rules_[type] = ContentSettingsRules::Create(*rules);
+    else
+      rules_.erase(type);
+  }
 }
 
 ContentSetting ContentSettingsManager::GetSetting(
@@ -76,8 +117,9 @@ ContentSetting ContentSettingsManager::GetSetting(
 
 std::vector<std::string> ContentSettingsManager::GetContentTypes() {
   std::vector<std::string> content_types;
-  const base::DictionaryValue* settings = nullptr;
-  content_settings_->GetAsDictionary(&settings);
+  const base::DictionaryValue* settings = content_settings_.settings();
+  if (!settings)
+    return content_types;
   for (base::DictionaryValue::Iterator it(*settings);
       !it.IsAtEnd();
       it.Advance()) {
@@ -95,47 +137,12 @@ ContentSetting ContentSettingsManager::GetContentSettingFromRules(
     ? ContentSetting::CONTENT_SETTING_ALLOW
     : ContentSetting::CONTENT_SETTING_BLOCK;
 
-  base::ListValue* rules = nullptr;
-  if (!content_settings_->GetList(content_type, &rules))
+  auto it = rules_.find(content_type);
+  if (it == rules_.end())
     return result;
 
-  // all rules are evaluated in order and the
-  // most specific matching rule will apply
-  for (base::ListValue::iterator it = rules->begin();
-       it != rules->end(); ++it) {
-    base::DictionaryValue* rule;
-    std::string pattern_string;
-    std::string setting_string;
-    if (!it->GetAsDictionary(&rule) ||
-        !rule->GetString("primaryPattern", &pattern_string) ||
-        !rule->GetString("setting", &setting_string)) {
-      // skip invalid entries
-      // TODO(bridiver) should also send an ipc error message
-      ++it;
-    } else {
-      std::string secondary_pattern_string;
-      rule->GetString("secondaryPattern", &secondary_pattern_string);
-
-      ContentSetting setting = result;
-      if (setting_string != "block" && setting_string != "deny") {
-        setting = ContentSetting::CONTENT_SETTING_ALLOW;
-      } else {
-        setting = ContentSetting::CONTENT_SETTING_BLOCK;
-      }
-
-      if (secondary_pattern_string == "[firstParty]") {
-        secondary_pattern_string = "[*.]" + primary_url.HostNoBrackets();
-      }
-
-      if (ContentSettingsPattern::FromString(
-            pattern_string).Matches(primary_url) &&
-          // if there is a secondary resource pattern it has to match as well
-          (secondary_pattern_string.empty() ||
-            ContentSettingsPattern::FromString(
-              secondary_pattern_string).Matches(secondary_url)))
-        result = setting;
-    }
-  }
-  return result;
+  ContentSetting setting = it->second->GetSetting(primary_url, secondary_url);
+  return setting == CONTENT_SETTING_DEFAULT ? result : setting;
 }
+
 }  // namespace atom
@@ -5,9 +5,12 @@
 #ifndef ATOM_RENDERER_CONTENT_SETTINGS_MANAGER_H_
 #define ATOM_RENDERER_CONTENT_SETTINGS_MANAGER_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
+#include "atom/common/content_settings_delta.h"
+#include "atom/renderer/content_settings_rules.h"
 #include "base/values.h"
 #include "components/content_settings/core/common/content_settings.h"
 #include "content/public/common/web_preferences.h"
@@ -30,7 +33,7 @@ class ContentSettingsManager : public content::RenderThreadObserver {
   static ContentSettingsManager* GetInstance();
 
   const base::DictionaryValue* content_settings() const
-    { return content_settings_.get(); };
+    { return content_settings_.settings(); };
 
   ContentSetting GetSetting(
       GURL primary_url,
@@ -53,11 +56,19 @@ class ContentSettingsManager : public content::RenderThreadObserver {
   void OnUpdateWebKitPrefs(
       const content::WebPreferences& web_preferences);
   void OnUpdateContentSettings(
+      int version,
       const base::DictionaryValue& content_settings);
-
+  void OnUpdateContentSettingsDelta(
+      int base_version,
+      int version,
+      const base::ListValue& splices);
 
   content::WebPreferences web_preferences_;
-  std::unique_ptr<base::DictionaryValue> content_settings_;
+  VersionedContentSettings content_settings_;
+  // Whether the full settings were asked for since the last full update.
+  bool resync_requested_;
+  // |content_settings_| compiled per content type.
+  std::map<std::string, std::unique_ptr<ContentSettingsRules>> rules_;
 
   DISALLOW_COPY_AND_ASSIGN(ContentSettingsManager);
 };
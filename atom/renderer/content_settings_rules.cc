@@ -0,0 +1,182 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/content_settings_rules.h"
+
+#include <limits>
+
+#include "base/values.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+const size_t kNoRule = std::numeric_limits<size_t>::max();
+
+// Caps the number of cached origin pairs per content type.
+const size_t kMaxCacheSize = 512;
+
+base::StringPiece StripTrailingDot(base::StringPiece host) {
+  if (!host.empty() && host[host.size() - 1] == '.')
+    host.remove_suffix(1);
+  return host;
+}
+
+}  // namespace
+
+ContentSettingsRules::ContentSettingsRules() {
+}
+
+ContentSettingsRules::~ContentSettingsRules() {
+}
+
+// static
+std::unique_ptr<ContentSettingsRules> ContentSettingsRules::Create(
+    const base::ListValue& list) {
+  std::unique_ptr<ContentSettingsRules> rules(new ContentSettingsRules);
+  for (size_t i = 0; i < list.GetSize(); ++i) {
+    const base::DictionaryValue* dict;
+    std::string primary;
+    std::string setting;
+    // Skip invalid entries.
+    if (!list.GetDictionary(i, &dict) ||
+        !dict->GetString("primaryPattern", &primary) ||
+        !dict->GetString("setting", &setting))
+      continue;
+
+    Rule rule;
+    rule.primary = ContentSettingsPattern::FromString(primary);
+    // A rule whose pattern does not parse can never match.
+    if (!rule.primary.IsValid())
+      continue;
+
+    std::string secondary;
+    dict->GetString("secondaryPattern", &secondary);
+    rule.first_party = secondary == "[firstParty]";
+    rule.has_secondary = !secondary.empty() && !rule.first_party;
+    if (rule.has_secondary) {
+      rule.secondary = ContentSettingsPattern::FromString(secondary);
+      if (!rule.secondary.IsValid())
+        continue;
+    }
+
+    rule.setting = (setting != "block" && setting != "deny")
+        ? CONTENT_SETTING_ALLOW : CONTENT_SETTING_BLOCK;
+    rules->rules_.push_back(rule);
+  }
+  rules->Build();
+  return rules;
+}
+
+ContentSetting ContentSettingsRules::GetSetting(
+    const GURL& primary_url, const GURL& secondary_url) const {
+  if (rules_.empty())
+    return CONTENT_SETTING_DEFAULT;
+
+  // Patterns only look at the path of file URLs, so other than that the
+  // result only depends on the origins.
+  bool cacheable = primary_url.SchemeIsHTTPOrHTTPS() &&
+      (secondary_url.is_empty() || secondary_url.SchemeIsHTTPOrHTTPS());
+  if (!cacheable)
+    return Lookup(primary_url, secondary_url);
+
+  std::string key = primary_url.GetOrigin().spec();
+  key.push_back(' ');
+  key.append(secondary_url.GetOrigin().spec());
+  auto it = cache_.find(key);
+  if (it != cache_.end())
+    return it->second;
+
+  ContentSetting setting = Lookup(primary_url, secondary_url);
+  if (cache_.size() >= kMaxCacheSize)
+    cache_.clear();
+  cache_[key] = setting;
+  return setting;
+}
+
+void ContentSettingsRules::Build() {
+  // Reserve first, the map keys point into |hosts_|.
+  hosts_.reserve(rules_.size());
+  std::vector<size_t> host_rules;
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const ContentSettingsPattern& pattern = rules_[i].primary;
+    const std::string& host = pattern.GetHost();
+    if (pattern.MatchesAllHosts() || host.empty() || host[0] == '[') {
+      any_host_.push_back(i);
+      continue;
+    }
+    hosts_.push_back(StripTrailingDot(host).as_string());
+    host_rules.push_back(i);
+  }
+
+  for (size_t i = 0; i < hosts_.size(); ++i) {
+    size_t index = host_rules[i];
+    HostMap& map = rules_[index].primary.HasDomainWildcard() ?
+        subdomain_hosts_ : exact_hosts_;
+    map[hosts_[i]].push_back(index);
+  }
+}
+
+ContentSetting ContentSettingsRules::Lookup(const GURL& primary_url,
+                                            const GURL& secondary_url) const {
+  // Built at most once per lookup, for "[firstParty]" rules.
+  std::unique_ptr<ContentSettingsPattern> first_party;
+  size_t best = kNoRule;
+
+  FindLastMatch(any_host_, primary_url, secondary_url, &first_party, &best);
+
+  base::StringPiece host = StripTrailingDot(primary_url.host_piece());
+  auto exact = exact_hosts_.find(host);
+  if (exact != exact_hosts_.end())
+    FindLastMatch(exact->second, primary_url, secondary_url, &first_party,
+                  &best);
+
+  if (!subdomain_hosts_.empty()) {
+    while (!host.empty()) {
+      auto it = subdomain_hosts_.find(host);
+      if (it != subdomain_hosts_.end())
+        FindLastMatch(it->second, primary_url, secondary_url, &first_party,
+                      &best);
+      size_t dot = host.find('.');
+      if (dot == base::StringPiece::npos)
+        break;
+      host.remove_prefix(dot + 1);
+    }
+  }
+
+  return best == kNoRule ? CONTENT_SETTING_DEFAULT : rules_[best].setting;
+}
+
+void ContentSettingsRules::FindLastMatch(
+    const std::vector<size_t>& candidates,
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    std::unique_ptr<ContentSettingsPattern>* first_party,
+    size_t* best) const {
+  for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+    // Candidates are in list order, nothing before |best| can win.
+    if (*best != kNoRule && *it <= *best)
+      return;
+
+    const Rule& rule = rules_[*it];
+    if (!rule.primary.Matches(primary_url))
+      continue;
+    if (rule.has_secondary && !rule.secondary.Matches(secondary_url))
+      continue;
+    if (rule.first_party) {
+      if (!*first_party)
+        first_party->reset(new ContentSettingsPattern(
+            ContentSettingsPattern::FromString(
+                "[*.]" + primary_url.HostNoBrackets())));
+      if (!(*first_party)->Matches(secondary_url))
+        continue;
+    }
+
+    *best = *it;
+    return;
+  }
+}
+
+}  // namespace atom
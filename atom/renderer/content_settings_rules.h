@@ -0,0 +1,89 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_CONTENT_SETTINGS_RULES_H_
+#define ATOM_RENDERER_CONTENT_SETTINGS_RULES_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
+
+class GURL;
+
+namespace base {
+class ListValue;
+}
+
+namespace atom {
+
+// The rules of one content type, compiled from the list sent by the browser.
+//
+// Patterns are parsed once and bucketed by the host of their primary
+// pattern, so a lookup only tests the rules that can possibly match. Rules
+// keep their list order and the last matching rule wins, as before. Results
+// for http(s) origins are cached until the rules are replaced.
+class ContentSettingsRules {
+ public:
+  static std::unique_ptr<ContentSettingsRules> Create(
+      const base::ListValue& rules);
+
+  ~ContentSettingsRules();
+
+  // Returns the setting of the last rule matching the URLs, or
+  // CONTENT_SETTING_DEFAULT if none does.
+  ContentSetting GetSetting(const GURL& primary_url,
+                            const GURL& secondary_url) const;
+
+  size_t size() const { return rules_.size(); }
+  size_t cache_size_for_testing() const { return cache_.size(); }
+
+ private:
+  struct Rule {
+    ContentSettingsPattern primary;
+    ContentSettingsPattern secondary;
+    bool has_secondary;
+    // The secondary URL has to be on the primary URL's host or a subdomain.
+    bool first_party;
+    ContentSetting setting;
+  };
+
+  using HostMap = std::unordered_map<base::StringPiece,
+                                     std::vector<size_t>,
+                                     base::StringPieceHash>;
+
+  ContentSettingsRules();
+
+  void Build();
+  ContentSetting Lookup(const GURL& primary_url,
+                        const GURL& secondary_url) const;
+  // Updates |best| with the last rule of |candidates| after |best| that
+  // matches.
+  void FindLastMatch(const std::vector<size_t>& candidates,
+                     const GURL& primary_url,
+                     const GURL& secondary_url,
+                     std::unique_ptr<ContentSettingsPattern>* first_party,
+                     size_t* best) const;
+
+  std::vector<Rule> rules_;
+  // Hosts of the primary patterns, which the keys of the maps point into.
+  std::vector<std::string> hosts_;
+
+  std::vector<size_t> any_host_;
+  HostMap exact_hosts_;
+  HostMap subdomain_hosts_;
+
+  mutable std::unordered_map<std::string, ContentSetting> cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsRules);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_CONTENT_SETTINGS_RULES_H_
@@ -0,0 +1,159 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/content_settings_rules.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+std::unique_ptr<base::DictionaryValue> MakeRule(const std::string& primary,
+                                                const std::string& secondary,
+                                                const std::string& setting) {
+  std::unique_ptr<base::DictionaryValue> rule(new base::DictionaryValue);
+  rule->SetString("primaryPattern", primary);
+  if (!secondary.empty())
+    rule->SetString("secondaryPattern", secondary);
+  rule->SetString("setting", setting);
+  return rule;
+}
+
+ContentSetting GetSetting(const ContentSettingsRules& rules,
+                          const std::string& primary_url) {
+  return rules.GetSetting(GURL(primary_url), GURL());
+}
+
+}  // namespace
+
+TEST(ContentSettingsRulesTest, LastMatchingRuleWins) {
+  base::ListValue list;
+  list.Append(MakeRule("*", "", "allow"));
+  list.Append(MakeRule("[*.]example.com", "", "block"));
+  list.Append(MakeRule("https://www.example.com", "", "allow"));
+  std::unique_ptr<ContentSettingsRules> rules =
+      ContentSettingsRules::Create(list);
+
+  EXPECT_EQ(CONTENT_SETTING_ALLOW, GetSetting(*rules, "http://other.com/"));
+  EXPECT_EQ(CONTENT_SETTING_BLOCK, GetSetting(*rules, "http://example.com/"));
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            GetSetting(*rules, "http://a.b.example.com/"));
+  EXPECT_EQ(CONTENT_SETTING_ALLOW,
+            GetSetting(*rules, "https://www.example.com/"));
+
+  // A broader rule later in the list overrides the specific one.
+  list.Append(MakeRule("[*.]example.com", "", "deny"));
+  rules = ContentSettingsRules::Create(list);
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            GetSetting(*rules, "https://www.example.com/"));
+}
+
+TEST(ContentSettingsRulesTest, SecondaryPatterns) {
+  base::ListValue list;
+  list.Append(MakeRule("*", "[*.]tracker.com", "block"));
+  list.Append(MakeRule("[*.]site.com", "[firstParty]", "allow"));
+  std::unique_ptr<ContentSettingsRules> rules =
+      ContentSettingsRules::Create(list);
+
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            rules->GetSetting(GURL("https://news.com/"),
+                              GURL("https://cdn.tracker.com/")));
+  EXPECT_EQ(CONTENT_SETTING_DEFAULT,
+            rules->GetSetting(GURL("https://news.com/"),
+                              GURL("https://cdn.other.com/")));
+  EXPECT_EQ(CONTENT_SETTING_ALLOW,
+            rules->GetSetting(GURL("https://site.com/"),
+                              GURL("https://img.site.com/")));
+  EXPECT_EQ(CONTENT_SETTING_DEFAULT,
+            rules->GetSetting(GURL("https://site.com/"),
+                              GURL("https://other.com/")));
+}
+
+TEST(ContentSettingsRulesTest, SkipsInvalidEntries) {
+  base::ListValue list;
+  list.Append(MakeRule("[*.]example.com", "", "block"));
+  // Invalid primary and secondary patterns.
+  list.Append(MakeRule("www.example.com*", "", "allow"));
+  list.Append(MakeRule("[*.]example.com", "*www.example.com", "allow"));
+  // Missing setting, and not a dictionary at all.
+  std::unique_ptr<base::DictionaryValue> no_setting(new base::DictionaryValue);
+  no_setting->SetString("primaryPattern", "[*.]example.com");
+  list.Append(std::move(no_setting));
+  list.AppendString("[*.]example.com");
+  // Still applied after all the invalid entries.
+  list.Append(MakeRule("[*.]other.com", "", "block"));
+  std::unique_ptr<ContentSettingsRules> rules =
+      ContentSettingsRules::Create(list);
+
+  EXPECT_EQ(2u, rules->size());
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            GetSetting(*rules, "http://www.example.com/"));
+  EXPECT_EQ(CONTENT_SETTING_BLOCK, GetSetting(*rules, "http://other.com/"));
+}
+
+TEST(ContentSettingsRulesTest, CachesOriginPairs) {
+  base::ListValue list;
+  list.Append(MakeRule("[*.]example.com", "", "block"));
+  std::unique_ptr<ContentSettingsRules> rules =
+      ContentSettingsRules::Create(list);
+  EXPECT_EQ(0u, rules->cache_size_for_testing());
+
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            GetSetting(*rules, "https://example.com/a"));
+  EXPECT_EQ(1u, rules->cache_size_for_testing());
+
+  // Same origin, other path.
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            GetSetting(*rules, "https://example.com/b?c"));
+  EXPECT_EQ(1u, rules->cache_size_for_testing());
+
+  // Another secondary origin is another entry.
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            rules->GetSetting(GURL("https://example.com/"),
+                              GURL("https://other.com/")));
+  EXPECT_EQ(2u, rules->cache_size_for_testing());
+
+  // Patterns look at the path of file URLs, so they are never cached.
+  EXPECT_EQ(CONTENT_SETTING_DEFAULT, GetSetting(*rules, "file:///tmp/a"));
+  EXPECT_EQ(2u, rules->cache_size_for_testing());
+}
+
+TEST(ContentSettingsRulesTest, ClearsFullCache) {
+  base::ListValue list;
+  list.Append(MakeRule("[*.]example.com", "", "block"));
+  std::unique_ptr<ContentSettingsRules> rules =
+      ContentSettingsRules::Create(list);
+
+  for (int i = 0; i < 512; ++i) {
+    GetSetting(*rules, "https://host" + base::IntToString(i) + ".com/");
+  }
+  EXPECT_EQ(512u, rules->cache_size_for_testing());
+
+  // The next new origin pair starts over with an empty cache.
+  EXPECT_EQ(CONTENT_SETTING_BLOCK, GetSetting(*rules, "https://example.com/"));
+  EXPECT_EQ(1u, rules->cache_size_for_testing());
+
+  // Cached results are still correct.
+  EXPECT_EQ(CONTENT_SETTING_BLOCK, GetSetting(*rules, "https://example.com/"));
+  EXPECT_EQ(CONTENT_SETTING_DEFAULT, GetSetting(*rules, "https://host1.com/"));
+  EXPECT_EQ(2u, rules->cache_size_for_testing());
+}
+
+TEST(ContentSettingsRulesTest, NoRules) {
+  base::ListValue list;
+  std::unique_ptr<ContentSettingsRules> rules =
+      ContentSettingsRules::Create(list);
+  EXPECT_EQ(CONTENT_SETTING_DEFAULT, GetSetting(*rules, "https://a.com/"));
+  EXPECT_EQ(0u, rules->cache_size_for_testing());
+}
+
+}  // namespace atom
@@ -4,30 +4,141 @@
 
 #include "brave/common/extensions/asar_source_map.h"
 
+#include <iterator>
+#include <map>
+#include <utility>
+
 #include "atom/common/asar/asar_util.h"
-#include "base/callback.h"
-#include "base/bind.h"
-#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/sha1.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "brave/common/extensions/module_code_cache.h"
 #include "gin/converter.h"
 
 namespace brave {
 
+// The final source of a module, handed to every isolate that loads it.
+class WrappedSource : public base::RefCountedThreadSafe<WrappedSource> {
+ public:
+  explicit WrappedSource(std::string source)
+      : source_(std::move(source)),
+        is_ascii_(base::IsStringASCII(source_)),
+        hash_(base::SHA1HashString(source_)) {}
+
+  // Keys the code cache of the module together with its path.
+  const std::string& hash() const { return hash_; }
+
+  // ASCII sources are shared with V8 as external strings instead of being
+  // copied onto the heap of each isolate.
+  v8::Local<v8::String> ToV8(v8::Isolate* isolate) {
+    if (!is_ascii_)
+      return gin::StringToV8(isolate, source_);
+    return v8::String::NewExternalOneByte(isolate, new Resource(this))
+        .ToLocalChecked();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<WrappedSource>;
+
+  class Resource : public v8::String::ExternalOneByteStringResource {
+   public:
+    explicit Resource(WrappedSource* source) : source_(source) {}
+    const char* data() const override { return source_->source_.data(); }
+    size_t length() const override { return source_->source_.size(); }
+
+   private:
+    scoped_refptr<WrappedSource> source_;
+  };
+
+  ~WrappedSource() {}
+
+  const std::string source_;
+  const bool is_ascii_;
+  const std::string hash_;
+
+  DISALLOW_COPY_AND_ASSIGN(WrappedSource);
+};
+
 namespace {
 
 static const char commonjs[] = "muon/module_system/commonjs";
 
-bool IsAsarPath(const base::FilePath& path) {
-  base::FilePath archive;
-  base::FilePath relative;
-  return asar::GetAsarArchivePath(path, &archive, &relative);
+// Names in scope of scripts run by extensions::ModuleSystem, see
+// ModuleSystem::WrapSource(). Modules are compiled on their own, so they get
+// these as parameters after require, module and console instead.
+const char* const kModuleSystemNames[] = {
+  "define", "requireNative", "requireAsync", "exports", "privates",
+  "$Array", "$Function", "$JSON", "$Object", "$RegExp", "$String", "$Error",
+  "$Promise",
+};
+
+std::string GetModuleSystemNames() {
+  return base::JoinString(std::vector<base::StringPiece>(
+      std::begin(kModuleSystemNames), std::end(kModuleSystemNames)), ", ");
+}
+
+// What a module name resolved to, shared by every environment in the
+// process so a require() costs one lookup and at most one read.
+class ModuleCache {
+ public:
+  struct Module {
+    // Empty if the name did not resolve to any file.
+    base::FilePath path;
+    // The wrapped source, only kept for modules packed in an archive since
+    // archives are read-only.
+    scoped_refptr<WrappedSource> source;
+  };
+
+  ModuleCache() {}
+
+  // Returns false if |key| has not been resolved yet.
+  bool Lookup(const std::string& key, Module* module) {
+    base::AutoLock auto_lock(lock_);
+    auto it = modules_.find(key);
+    if (it == modules_.end())
+      return false;
+    *module = it->second;
+    return true;
+  }
+
+  void SetPath(const std::string& key, const base::FilePath& path) {
+    base::AutoLock auto_lock(lock_);
+    Module& module = modules_[key];
+    if (module.path != path)
+      module.source = nullptr;
+    module.path = path;
+  }
+
+  void SetSource(const std::string& key,
+                 scoped_refptr<WrappedSource> source) {
+    base::AutoLock auto_lock(lock_);
+    modules_[key].source = source;
+  }
+
+ private:
+  base::Lock lock_;
+  std::map<std::string, Module> modules_;
+
+  DISALLOW_COPY_AND_ASSIGN(ModuleCache);
+};
+
+base::LazyInstance<ModuleCache>::Leaky g_module_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool IsInArchive(const base::FilePath& path) {
+  base::FilePath asar_path;
+  base::FilePath relative_path;
+  return asar::GetAsarArchivePath(path, &asar_path, &relative_path);
 }
 
-bool ReadFromPath(
-    base::Callback<bool(const base::FilePath& path, std::string* contents)>,
-    const base::FilePath& file,
-    const base::FilePath& path,
-    std::string* source) {
+// Finds the first of the candidate files for |file| that exists, without
+// reading any of them.
+base::FilePath ResolveInPath(const base::FilePath& file,
+                             const base::FilePath& path) {
   base::FilePath file_path = path.Append(file);
   if (!file_path.MatchesExtension(FILE_PATH_LITERAL(".js")))
     file_path = file_path.AddExtension(FILE_PATH_LITERAL("js"));
@@ -42,27 +153,23 @@ bool ReadFromPath(
       .Append(file)
       .AddExtension(FILE_PATH_LITERAL("js"));
 
-  return asar::ReadFileToString(file_path, source) ||
-      asar::ReadFileToString(module_path1, source) ||
-      asar::ReadFileToString(module_path2, source);
+  for (const base::FilePath& candidate :
+       { file_path, module_path1, module_path2 }) {
+    if (asar::IsFile(candidate))
+      return candidate;
+  }
+  return base::FilePath();
 }
 
-bool ReadFromSearchPaths(const std::vector<base::FilePath>& search_paths,
-                        const base::FilePath& file_path,
-                        std::string* source) {
+base::FilePath ResolveInSearchPaths(
+    const std::vector<base::FilePath>& search_paths,
+    const base::FilePath& file_path) {
   for (size_t i = 0; i < search_paths.size(); ++i) {
-    if (IsAsarPath(search_paths[i])) {
-      if (!ReadFromPath(base::Bind(&asar::ReadFileToString),
-          file_path, search_paths[i], source))
-        continue;
-    } else {
-      if (!ReadFromPath(base::Bind(&base::ReadFileToString),
-          file_path, search_paths[i], source))
-        continue;
-    }
-    return true;
+    base::FilePath resolved = ResolveInPath(file_path, search_paths[i]);
+    if (!resolved.empty())
+      return resolved;
   }
-  return false;
+  return base::FilePath();
 }
 
 const base::FilePath GetFilePath(const std::string& name) {
@@ -99,31 +206,113 @@ const base::FilePath GetFilePath(const std::string& name) {
   return path;
 }
 
+// Whether nothing can be added to |path|, an archive or a path inside one.
+bool IsReadOnlyPath(const base::FilePath& path) {
+  return path.MatchesExtension(FILE_PATH_LITERAL(".asar")) ||
+      IsInArchive(path);
+}
+
+// Resolves |file_path| once per process. Misses are only remembered with
+// |cache_misses|, since files can be added to plain directories at any time.
+ModuleCache::Module GetModule(const std::vector<base::FilePath>& search_paths,
+                              const std::string& cache_key,
+                              const base::FilePath& file_path,
+                              bool cache_misses) {
+  ModuleCache::Module module;
+  if (!g_module_cache.Get().Lookup(cache_key, &module)) {
+    module.path = ResolveInSearchPaths(search_paths, file_path);
+    if (!module.path.empty() || cache_misses)
+      g_module_cache.Get().SetPath(cache_key, module.path);
+  }
+  return module;
+}
+
 }  // namespace
 
 AsarSourceMap::AsarSourceMap(
     const std::vector<base::FilePath>& search_paths)
-    : search_paths_(search_paths) {
+    : search_paths_(search_paths),
+      cache_misses_(true) {
+  // The same name can resolve differently with other search paths.
+  for (const auto& path : search_paths_) {
+    cache_prefix_.append(path.AsUTF8Unsafe());
+    cache_prefix_.push_back('\n');
+    if (!IsReadOnlyPath(path))
+      cache_misses_ = false;
+  }
 }
 
 AsarSourceMap::~AsarSourceMap() {
 }
 
+scoped_refptr<WrappedSource> AsarSourceMap::GetWrappedSource(
+    const std::string& name,
+    base::FilePath* module_path) const {
+  std::string cache_key = cache_prefix_ + name;
+  base::FilePath file_path = GetFilePath(name);
+  ModuleCache::Module module =
+      GetModule(search_paths_, cache_key, file_path, cache_misses_);
+  *module_path = module.path;
+  if (module.source)
+    return module.source;
+
+  // Packed modules come back as views into the mapped archive.
+  scoped_refptr<base::RefCountedMemory> contents;
+  if (!module.path.empty())
+    contents = asar::ReadFileToMemory(module.path);
+  if (!contents) {
+    // Plain files may have moved since they were resolved.
+    module.path = ResolveInSearchPaths(search_paths_, file_path);
+    g_module_cache.Get().SetPath(cache_key, module.path);
+    *module_path = module.path;
+    if (!module.path.empty())
+      contents = asar::ReadFileToMemory(module.path);
+  }
+  if (!contents)
+    return nullptr;
+
+  base::StringPiece source(reinterpret_cast<const char*>(contents->front()),
+                           contents->size());
+  scoped_refptr<WrappedSource> wrapped;
+  if (name == commonjs) {
+    wrapped = new WrappedSource(source.as_string());
+  } else {
+    // A parenthesized function is compiled eagerly, so its code ends up in
+    // the code cache. It is strict like the ModuleSystem wrapper it used to
+    // be nested in.
+    const std::string prefix = "(function (require, module, console, " +
+        GetModuleSystemNames() + ") { 'use strict'; ";
+    static const char kSuffix[] = "\n})";
+
+    std::string result;
+    result.reserve(prefix.size() + source.size() + sizeof(kSuffix));
+    result.append(prefix);
+    source.AppendToString(&result);
+    result.append(kSuffix);
+    wrapped = new WrappedSource(std::move(result));
+  }
+
+  // Plain files may still change, e.g. with --source-root.
+  if (IsInArchive(module.path))
+    g_module_cache.Get().SetSource(cache_key, wrapped);
+  return wrapped;
+}
+
 v8::Local<v8::String> AsarSourceMap::GetSource(
     v8::Isolate* isolate,
     const std::string& name) const {
-  std::string source;
-  if (ReadFromSearchPaths(search_paths_, GetFilePath(name), &source)) {
-    if (name != commonjs) {
-      source =
-          "const fn = function (require, module, console) { " + source + " };"
-          "require('" +
-            commonjs +
-          "').require(fn, exports, '" +
-          GetFilePath(name).AsUTF8Unsafe() +
-          "', this);";
-    }
-
+  if (name == commonjs) {
+    base::FilePath module_path;
+    scoped_refptr<WrappedSource> wrapped =
+        GetWrappedSource(name, &module_path);
+    if (wrapped)
+      return wrapped->ToV8(isolate);
+  } else if (Contains(name)) {
+    // The module itself is compiled by CompileModule() with the code cache.
+    std::string source = std::string("require('") + commonjs +
+        "').run('" + name + "', exports, '" +
+        GetFilePath(name).AsUTF8Unsafe() + "', this, [" +
+        GetModuleSystemNames() + "]);";
     return gin::StringToV8(isolate, source);
   }
 
@@ -131,9 +320,30 @@ v8::Local<v8::String> AsarSourceMap::GetSource(
   return v8::Local<v8::String>();
 }
 
+v8::MaybeLocal<v8::Function> AsarSourceMap::CompileModule(
+    v8::Isolate* isolate,
+    const std::string& name) const {
+  base::FilePath module_path;
+  scoped_refptr<WrappedSource> wrapped = GetWrappedSource(name, &module_path);
+  if (!wrapped)
+    return v8::MaybeLocal<v8::Function>();
+
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Script> script;
+  v8::Local<v8::Value> result;
+  if (!ModuleCodeCache::GetInstance()->Compile(
+          isolate, module_path.AsUTF8Unsafe(), wrapped->hash(),
+          wrapped->ToV8(isolate)).ToLocal(&script) ||
+      !script->Run(context).ToLocal(&result) || !result->IsFunction())
+    return v8::MaybeLocal<v8::Function>();
+  return result.As<v8::Function>();
+}
+
 bool AsarSourceMap::Contains(const std::string& name) const {
-  std::string source;
-  return ReadFromSearchPaths(search_paths_, GetFilePath(name), &source);
+  std::string cache_key = cache_prefix_ + name;
+  ModuleCache::Module module =
+      GetModule(search_paths_, cache_key, GetFilePath(name), cache_misses_);
+  return !module.path.empty();
 }
 
 }  // namespace brave
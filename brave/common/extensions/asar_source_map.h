@@ -10,11 +10,14 @@
 
 #include "base/compiler_specific.h"
 #include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
 #include "extensions/renderer/source_map.h"
 #include "v8/include/v8.h"
 
 namespace brave {
 
+class WrappedSource;
+
 class AsarSourceMap : public extensions::SourceMap {
  public:
   explicit AsarSourceMap(const std::vector<base::FilePath>& search_paths);
@@ -24,8 +27,25 @@ class AsarSourceMap : public extensions::SourceMap {
                                  const std::string& name) const override;
   bool Contains(const std::string& name) const override;
 
+  // Compiles the CommonJS module |name| to the function that runs it, using
+  // the process-wide code cache. Returns an empty handle with an exception
+  // scheduled if it fails to compile, or without one if it is missing.
+  v8::MaybeLocal<v8::Function> CompileModule(v8::Isolate* isolate,
+                                             const std::string& name) const;
+
  private:
+  // Returns the wrapped source of |name| and the file it was read from, or
+  // null if it does not resolve.
+  scoped_refptr<WrappedSource> GetWrappedSource(
+      const std::string& name,
+      base::FilePath* module_path) const;
+
   std::vector<base::FilePath> search_paths_;
+  // Prepended to module names to key the process-wide module cache.
+  std::string cache_prefix_;
+  // Whether modules that are not found can be remembered, only true when all
+  // the search paths are in archives.
+  bool cache_misses_;
 
   DISALLOW_COPY_AND_ASSIGN(AsarSourceMap);
 };
@@ -0,0 +1,82 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/asar_source_map.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/pickle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave {
+
+namespace {
+
+bool WriteString(const base::FilePath& path, const std::string& contents) {
+  return base::WriteFile(path, contents.data(), contents.size()) ==
+      static_cast<int>(contents.size());
+}
+
+// Writes an archive with a single "packed.js" file holding |contents|.
+bool WriteArchive(const base::FilePath& path, const std::string& contents) {
+  base::Pickle header;
+  header.WriteString(
+      "{\"files\":{\"packed.js\":{\"size\":" +
+      std::to_string(contents.size()) + ",\"offset\":\"0\"}}}");
+  base::Pickle header_size;
+  header_size.WriteUInt32(header.size());
+
+  std::string archive(static_cast<const char*>(header_size.data()),
+                      header_size.size());
+  archive.append(static_cast<const char*>(header.data()), header.size());
+  archive.append(contents);
+  return WriteString(path, archive);
+}
+
+}  // namespace
+
+TEST(AsarSourceMapTest, FindsFilesAddedToPlainPaths) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  AsarSourceMap source_map(std::vector<base::FilePath>{dir.GetPath()});
+
+  EXPECT_FALSE(source_map.Contains("late"));
+  ASSERT_TRUE(WriteString(dir.GetPath().AppendASCII("late.js"),
+                          "module.exports = 1"));
+  EXPECT_TRUE(source_map.Contains("late"));
+  EXPECT_TRUE(source_map.Contains("./late.js"));
+}
+
+TEST(AsarSourceMapTest, ResolvesModulesInArchives) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath archive = dir.GetPath().AppendASCII("modules.asar");
+  ASSERT_TRUE(WriteArchive(archive, "module.exports = 1"));
+  AsarSourceMap source_map(std::vector<base::FilePath>{archive});
+
+  EXPECT_TRUE(source_map.Contains("packed"));
+  EXPECT_FALSE(source_map.Contains("missing"));
+  // Archives can not change, so the miss is remembered.
+  EXPECT_FALSE(source_map.Contains("missing"));
+}
+
+TEST(AsarSourceMapTest, ArchivesBeforePlainPaths) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath archive = dir.GetPath().AppendASCII("modules.asar");
+  base::FilePath plain = dir.GetPath().AppendASCII("plain");
+  ASSERT_TRUE(WriteArchive(archive, "module.exports = 1"));
+  ASSERT_TRUE(base::CreateDirectory(plain));
+  AsarSourceMap source_map(std::vector<base::FilePath>{archive, plain});
+
+  // A plain search path later in the list can still gain the module.
+  EXPECT_FALSE(source_map.Contains("other"));
+  ASSERT_TRUE(WriteString(plain.AppendASCII("other.js"), ""));
+  EXPECT_TRUE(source_map.Contains("other"));
+}
+
+}  // namespace brave
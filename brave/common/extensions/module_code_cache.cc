@@ -0,0 +1,156 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/module_code_cache.h"
+
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/lazy_instance.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/thread_restrictions.h"
+#include "gin/converter.h"
+
+namespace brave {
+
+namespace {
+
+base::LazyInstance<ModuleCodeCache>::Leaky g_module_code_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+ModuleCodeCache::ModuleCodeCache() : hits_(0) {
+}
+
+ModuleCodeCache::~ModuleCodeCache() {
+}
+
+// static
+ModuleCodeCache* ModuleCodeCache::GetInstance() {
+  return g_module_code_cache.Pointer();
+}
+
+void ModuleCodeCache::SetDirectory(const base::FilePath& directory) {
+  std::map<std::string, std::string> entries;
+  {
+    base::AutoLock auto_lock(lock_);
+    directory_ = directory;
+    entries = entries_;
+  }
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (!base::CreateDirectory(directory))
+    return;
+  for (const auto& entry : entries) {
+    base::FilePath path = GetEntryPath(entry.first);
+    if (!base::PathExists(path))
+      base::ImportantFileWriter::WriteFileAtomically(path, entry.second);
+  }
+}
+
+v8::MaybeLocal<v8::Script> ModuleCodeCache::Compile(
+    v8::Isolate* isolate,
+    const std::string& path,
+    const std::string& source_hash,
+    v8::Local<v8::String> source) {
+  std::string key = path + '\n' + source_hash;
+  std::string data;
+  bool cached = Lookup(key, &data);
+
+  v8::ScriptOrigin origin(gin::StringToV8(isolate, path));
+  // |data| outlives the compile, so V8 does not need its own copy.
+  v8::ScriptCompiler::Source script_source(source, origin,
+      cached ? new v8::ScriptCompiler::CachedData(
+                   reinterpret_cast<const uint8_t*>(data.data()),
+                   static_cast<int>(data.size()))
+             : nullptr);
+  v8::MaybeLocal<v8::Script> script = v8::ScriptCompiler::Compile(
+      isolate->GetCurrentContext(), &script_source,
+      cached ? v8::ScriptCompiler::kConsumeCodeCache
+             : v8::ScriptCompiler::kProduceCodeCache);
+  if (script.IsEmpty())
+    return script;
+
+  const v8::ScriptCompiler::CachedData* cached_data =
+      script_source.GetCachedData();
+  if (cached) {
+    // Caches of another V8 version or flags are rejected, replace them.
+    if (cached_data && cached_data->rejected) {
+      Remove(key);
+    } else {
+      base::AutoLock auto_lock(lock_);
+      ++hits_;
+    }
+  } else if (cached_data && !cached_data->rejected) {
+    Store(key, std::string(reinterpret_cast<const char*>(cached_data->data),
+                           cached_data->length));
+  }
+  return script;
+}
+
+size_t ModuleCodeCache::size() {
+  base::AutoLock auto_lock(lock_);
+  return entries_.size();
+}
+
+size_t ModuleCodeCache::hits() {
+  base::AutoLock auto_lock(lock_);
+  return hits_;
+}
+
+bool ModuleCodeCache::Lookup(const std::string& key, std::string* data) {
+  {
+    base::AutoLock auto_lock(lock_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      *data = it->second;
+      return true;
+    }
+  }
+
+  base::FilePath path = GetEntryPath(key);
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (path.empty() || !base::ReadFileToString(path, data) || data->empty())
+    return false;
+  base::AutoLock auto_lock(lock_);
+  entries_[key] = *data;
+  return true;
+}
+
+void ModuleCodeCache::Store(const std::string& key, const std::string& data) {
+  {
+    base::AutoLock auto_lock(lock_);
+    entries_[key] = data;
+  }
+
+  base::FilePath path = GetEntryPath(key);
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  // Other threads may write the same entry, each write is atomic.
+  if (!path.empty())
+    base::ImportantFileWriter::WriteFileAtomically(path, data);
+}
+
+void ModuleCodeCache::Remove(const std::string& key) {
+  {
+    base::AutoLock auto_lock(lock_);
+    entries_.erase(key);
+  }
+
+  base::FilePath path = GetEntryPath(key);
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (!path.empty())
+    base::DeleteFile(path, false);
+}
+
+base::FilePath ModuleCodeCache::GetEntryPath(const std::string& key) {
+  base::AutoLock auto_lock(lock_);
+  if (directory_.empty())
+    return base::FilePath();
+  // Keys hold paths, so files are named after their hash.
+  return directory_.AppendASCII(base::HexEncode(
+      base::SHA1HashString(key).data(), base::kSHA1Length));
+}
+
+}  // namespace brave
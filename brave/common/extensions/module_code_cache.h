@@ -0,0 +1,63 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
+#define BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+// V8 code caches of module scripts, shared by every isolate in the process so
+// only the first environment that loads a module pays for compiling it.
+// Entries are keyed by the path and the content hash of the script, so a file
+// that changes on disk is compiled again. With a directory set, entries are
+// also kept on disk, so the next run of the app starts warm.
+class ModuleCodeCache {
+ public:
+  ModuleCodeCache();
+  ~ModuleCodeCache();
+
+  static ModuleCodeCache* GetInstance();
+
+  // Reads entries missing in memory from |directory| and writes new ones to
+  // it, including those produced before it was set.
+  void SetDirectory(const base::FilePath& directory);
+
+  // Compiles |source| in the current context of |isolate| with the cached
+  // code of |path| and |source_hash|, or produces it if there is none yet.
+  v8::MaybeLocal<v8::Script> Compile(v8::Isolate* isolate,
+                                     const std::string& path,
+                                     const std::string& source_hash,
+                                     v8::Local<v8::String> source);
+
+  size_t size();
+  // Number of compiles that used a cached entry.
+  size_t hits();
+
+ private:
+  bool Lookup(const std::string& key, std::string* data);
+  // Stores or removes the entry of |key| in memory and on disk.
+  void Store(const std::string& key, const std::string& data);
+  void Remove(const std::string& key);
+  // Empty without a directory.
+  base::FilePath GetEntryPath(const std::string& key);
+
+  base::Lock lock_;
+  base::FilePath directory_;
+  std::map<std::string, std::string> entries_;
+  size_t hits_;
+
+  DISALLOW_COPY_AND_ASSIGN(ModuleCodeCache);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
@@ -0,0 +1,189 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/module_code_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "gin/converter.h"
+#include "gin/public/isolate_holder.h"
+#include "gin/test/v8_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace brave {
+
+namespace {
+
+class ModuleCodeCacheTest : public gin::V8Test {
+ protected:
+  // Compiles and runs |source| as |path|, returning its result as a string.
+  std::string Run(const std::string& path, const std::string& source) {
+    return RunWith(&cache_, path, source);
+  }
+
+  std::string RunWith(ModuleCodeCache* cache,
+                      const std::string& path,
+                      const std::string& source) {
+    v8::Isolate* isolate = instance_->isolate();
+    v8::Local<v8::Script> script;
+    if (!cache->Compile(isolate, path, "hash of " + source,
+                        gin::StringToV8(isolate, source)).ToLocal(&script))
+      return std::string();
+    v8::Local<v8::Value> result;
+    std::string value;
+    if (!script->Run(isolate->GetCurrentContext()).ToLocal(&result) ||
+        !gin::ConvertFromV8(isolate, result, &value))
+      return std::string();
+    return value;
+  }
+
+  ModuleCodeCache cache_;
+};
+
+int CountFiles(const base::FilePath& directory) {
+  int count = 0;
+  base::FileEnumerator files(directory, false, base::FileEnumerator::FILES);
+  for (base::FilePath path = files.Next(); !path.empty(); path = files.Next())
+    ++count;
+  return count;
+}
+
+// A module with enough functions for compiling it to take a while.
+std::string MakeModule(int index) {
+  std::string source = "(function () {\n";
+  for (int i = 0; i < 200; ++i) {
+    base::StringAppendF(&source,
+        "  const f%d = (function (a, b) {\n"
+        "    const c = [a, b].map((x) => x * %d + %d)\n"
+        "    return c.reduce((x, y) => x + y, 0) + JSON.stringify({a, b})\n"
+        "  })\n",
+        i, i, index);
+  }
+  base::StringAppendF(&source, "  return 'module %d'\n})()", index);
+  return source;
+}
+
+}  // namespace
+
+TEST_F(ModuleCodeCacheTest, ReusesCodeOfSameModule) {
+  v8::HandleScope handle_scope(instance_->isolate());
+  const std::string source = "(function () { return 'a' + 'b' })()";
+
+  EXPECT_EQ("ab", Run("/app/a.js", source));
+  EXPECT_EQ(1u, cache_.size());
+  EXPECT_EQ(0u, cache_.hits());
+
+  EXPECT_EQ("ab", Run("/app/a.js", source));
+  EXPECT_EQ(1u, cache_.size());
+  EXPECT_EQ(1u, cache_.hits());
+}
+
+TEST_F(ModuleCodeCacheTest, KeysByPathAndContents) {
+  v8::HandleScope handle_scope(instance_->isolate());
+
+  EXPECT_EQ("a", Run("/app/a.js", "'a'"));
+  EXPECT_EQ("a", Run("/app/b.js", "'a'"));
+  // A changed file is compiled again instead of running stale code.
+  EXPECT_EQ("b", Run("/app/a.js", "'b'"));
+  EXPECT_EQ(3u, cache_.size());
+  EXPECT_EQ(0u, cache_.hits());
+}
+
+TEST_F(ModuleCodeCacheTest, SkipsScriptsThatFailToCompile) {
+  v8::HandleScope handle_scope(instance_->isolate());
+  v8::TryCatch try_catch(instance_->isolate());
+
+  EXPECT_EQ(std::string(), Run("/app/a.js", "function ("));
+  EXPECT_TRUE(try_catch.HasCaught());
+  EXPECT_EQ(0u, cache_.size());
+}
+
+TEST_F(ModuleCodeCacheTest, PersistsEntriesToDirectory) {
+  v8::HandleScope handle_scope(instance_->isolate());
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  const std::string source = "(function () { return 'a' + 'b' })()";
+
+  // Entries produced before the directory is known are written too.
+  EXPECT_EQ("ab", Run("/app/a.js", source));
+  cache_.SetDirectory(dir.GetPath());
+  EXPECT_EQ("ab", Run("/app/b.js", source));
+  EXPECT_EQ(2, CountFiles(dir.GetPath()));
+
+  // As in the next run of the app.
+  ModuleCodeCache next_run;
+  next_run.SetDirectory(dir.GetPath());
+  EXPECT_EQ("ab", RunWith(&next_run, "/app/a.js", source));
+  EXPECT_EQ("ab", RunWith(&next_run, "/app/b.js", source));
+  EXPECT_EQ(2u, next_run.hits());
+}
+
+TEST_F(ModuleCodeCacheTest, ReplacesCorruptEntriesOnDisk) {
+  v8::HandleScope handle_scope(instance_->isolate());
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  cache_.SetDirectory(dir.GetPath());
+  EXPECT_EQ("a", Run("/app/a.js", "'a'"));
+
+  base::FileEnumerator files(dir.GetPath(), false,
+                             base::FileEnumerator::FILES);
+  base::FilePath entry = files.Next();
+  ASSERT_FALSE(entry.empty());
+  ASSERT_EQ(7, base::WriteFile(entry, "garbage", 7));
+
+  ModuleCodeCache next_run;
+  next_run.SetDirectory(dir.GetPath());
+  EXPECT_EQ("a", RunWith(&next_run, "/app/a.js", "'a'"));
+  EXPECT_EQ(0u, next_run.hits());
+  EXPECT_FALSE(base::PathExists(entry));
+
+  // Produced again by the compile after.
+  EXPECT_EQ("a", RunWith(&next_run, "/app/a.js", "'a'"));
+  EXPECT_TRUE(base::PathExists(entry));
+}
+
+// Compiles the modules of a worker in a new context, once with a cold cache
+// and once with the one the first start left on disk.
+TEST_F(ModuleCodeCacheTest, WorkerStartTime) {
+  const int kModules = 20;
+  v8::Isolate* isolate = instance_->isolate();
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+
+  std::vector<std::string> modules;
+  for (int i = 0; i < kModules; ++i)
+    modules.push_back(MakeModule(i));
+
+  base::TimeDelta times[2];
+  for (int run = 0; run < 2; ++run) {
+    ModuleCodeCache cache;
+    cache.SetDirectory(dir.GetPath());
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kModules; ++i) {
+      EXPECT_EQ(base::StringPrintf("module %d", i),
+                RunWith(&cache, base::StringPrintf("/app/%d.js", i),
+                        modules[i]));
+    }
+    times[run] = base::TimeTicks::Now() - start;
+    EXPECT_EQ(run == 0 ? 0u : static_cast<size_t>(kModules), cache.hits());
+  }
+
+  perf_test::PrintResult("module_code_cache", "", "worker_start_cold",
+                         times[0].InMillisecondsF(), "ms", true);
+  perf_test::PrintResult("module_code_cache", "", "worker_start_warm",
+                         times[1].InMillisecondsF(), "ms", true);
+}
+
+}  // namespace brave
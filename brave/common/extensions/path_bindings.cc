@@ -8,7 +8,6 @@
 
 #include "base/files/file_path.h"
 #include "extensions/renderer/script_context.h"
-#include "extensions/renderer/source_map.h"
 #include "extensions/renderer/v8_helpers.h"
 #include "v8/include/v8.h"
 
@@ -16,7 +15,7 @@ namespace brave {
 
 PathBindings::PathBindings(
         extensions::ScriptContext* context,
-        extensions::SourceMap* source_map)
+        const AsarSourceMap* source_map)
     : extensions::ObjectBackedNativeHandler(context),
       source_map_(source_map) {
   RouteFunction("append",
@@ -25,6 +24,8 @@ PathBindings::PathBindings(
               base::Bind(&PathBindings::DirName, base::Unretained(this)));
   RouteFunction("require",
               base::Bind(&PathBindings::Require, base::Unretained(this)));
+  RouteFunction("compile",
+              base::Bind(&PathBindings::Compile, base::Unretained(this)));
   // TODO(bridiver) - implement require.paths
 }
 
@@ -76,4 +77,27 @@ void PathBindings::Require(
     source_map_->Contains(*v8::String::Utf8Value(args[0])));
 }
 
+void PathBindings::Compile(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  if (args.Length() != 1 || !args[0]->IsString()) {
+    GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+        GetIsolate(), "Invalid arguments to 'compile'"));
+    return;
+  }
+
+  std::string name(*v8::String::Utf8Value(args[0]));
+  v8::TryCatch try_catch(GetIsolate());
+  v8::Local<v8::Function> module;
+  if (!source_map_->CompileModule(GetIsolate(), name).ToLocal(&module)) {
+    if (try_catch.HasCaught()) {
+      try_catch.ReThrow();
+    } else {
+      GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+          GetIsolate(), ("Cannot find module '" + name + "'").c_str()));
+    }
+    return;
+  }
+  args.GetReturnValue().Set(module);
+}
+
 }  // namespace brave
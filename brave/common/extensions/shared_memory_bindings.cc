@@ -2,162 +2,206 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <utility>
-
 #include "brave/common/extensions/shared_memory_bindings.h"
 
-#include "base/memory/shared_memory.h"
-#include "base/pickle.h"
-#include "content/child/child_thread_impl.h"
-#include "content/public/child/child_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "brave/common/shared_memory_pool.h"
 #include "extensions/renderer/script_context.h"
 #include "native_mate/arguments.h"
 #include "native_mate/converter.h"
 #include "native_mate/object_template_builder.h"
 #include "native_mate/wrappable.h"
-#include "url/gurl.h"
 #include "v8/include/v8.h"
 
-using content::ChildThread;
-using content::ChildThreadImpl;
-
-namespace mate {
+namespace brave {
 
-v8::Local<v8::Value> Converter<base::SharedMemory*>::ToV8(
-    v8::Isolate* isolate, base::SharedMemory* val) {
-  if (!val) {
-    return v8::Null(isolate);
+namespace {
+
+// Serializes into pooled segments, moving on to the next size class when the
+// value outgrows the current one and to the heap past the largest one.
+class SegmentSerializer : public v8::ValueSerializer::Delegate {
+ public:
+  explicit SegmentSerializer(v8::Isolate* isolate)
+      : isolate_(isolate),
+        serializer_(isolate, this) {}
+
+  // Returns the segment holding the value, or null with an exception
+  // pending.
+  scoped_refptr<SharedSegment> Serialize(v8::Local<v8::Value> value,
+                                         uint32_t* size) {
+    serializer_.WriteHeader();
+    if (!serializer_.WriteValue(isolate_->GetCurrentContext(), value)
+             .FromMaybe(false))
+      return nullptr;
+
+    std::pair<uint8_t*, size_t> buffer = serializer_.Release();
+    if (buffer.second > std::numeric_limits<uint32_t>::max()) {
+      FreeBufferMemory(buffer.first);
+      ThrowError("The value is too large to be shared");
+      return nullptr;
+    }
+    *size = static_cast<uint32_t>(buffer.second);
+    if (InSegment(buffer.first))
+      return segment_;
+
+    scoped_refptr<SharedSegment> segment =
+        SharedSegment::Create(buffer.second, false);
+    if (segment)
+      memcpy(segment->payload(), buffer.first, buffer.second);
+    else
+      ThrowError("Could not create shared memory");
+    FreeBufferMemory(buffer.first);
+    return segment;
   }
 
-  if (!val->Map(sizeof(base::Pickle::Header)))
-    return v8::Null(isolate);
-
-  // Get the payload size
-  base::Pickle::Header* pickle_header =
-      reinterpret_cast<base::Pickle::Header*>(val->memory());
-
-  // Now map in the rest of the block.
-  int pickle_size =
-      sizeof(base::Pickle::Header) + pickle_header->payload_size;
-  val->Unmap();
-  if (!val->Map(pickle_size))
-    return v8::Null(isolate);
-
-  base::Pickle pickle(reinterpret_cast<char*>(val->memory()),
-                      pickle_size);
+  // v8::ValueSerializer::Delegate:
+  void ThrowDataCloneError(v8::Local<v8::String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
 
-  base::PickleIterator iter(pickle);
-  int length = 0;
-  if (!iter.ReadInt(&length))
-    return v8::Null(isolate);
+  void* ReallocateBufferMemory(void* old_buffer,
+                               size_t size,
+                               size_t* actual_size) override {
+    if (old_buffer && !InSegment(old_buffer)) {
+      *actual_size = size;
+      return realloc(old_buffer, size);
+    }
 
-  const char* body = NULL;
-  if (!iter.ReadBytes(&body, length))
-    return v8::Null(isolate);
+    // Whatever has been written so far fits in the old segment.
+    scoped_refptr<SharedSegment> segment =
+        SharedMemoryPool::GetInstance()->Acquire(size);
+    void* buffer = nullptr;
+    if (segment) {
+      buffer = segment->payload();
+      *actual_size = segment->capacity();
+    } else {
+      buffer = malloc(size);
+      *actual_size = size;
+    }
+    if (!buffer)
+      return nullptr;
+    if (old_buffer)
+      memcpy(buffer, old_buffer, segment_->capacity());
+    segment_ = segment;
+    return buffer;
+  }
 
-  v8::Local<v8::Context> context = isolate->GetCurrentContext();
-  v8::ValueDeserializer deserializer(
-      isolate, reinterpret_cast<const uint8_t*>(body), length);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(context).FromMaybe(false)) {
-    v8::Local<v8::Value> data =
-        deserializer.ReadValue(context).ToLocalChecked();
-    return data;
+  void FreeBufferMemory(void* buffer) override {
+    if (!InSegment(buffer))
+      free(buffer);
   }
 
-  return v8::Null(isolate);
-}
+ private:
+  bool InSegment(void* buffer) const {
+    return segment_ && buffer == segment_->payload();
+  }
 
-bool Converter<base::SharedMemory*>::FromV8(v8::Isolate* isolate,
-    v8::Local<v8::Value> val,
-    base::SharedMemory** out) {
-  brave::SharedMemoryWrapper* wrapper = nullptr;
-  if (!ConvertFromV8(isolate, val, &wrapper) || !wrapper)
-    return false;
+  void ThrowError(const char* message) {
+    isolate_->ThrowException(v8::Exception::Error(
+        mate::StringToV8(isolate_, message)));
+  }
 
-  *out = wrapper->shared_memory();
-  return true;
-}
+  v8::Isolate* isolate_;
+  // Outlives |serializer_|, which frees its buffer when destroyed.
+  scoped_refptr<SharedSegment> segment_;
+  v8::ValueSerializer serializer_;
 
-}  // namespace mate
+  DISALLOW_COPY_AND_ASSIGN(SegmentSerializer);
+};
 
-namespace brave {
+}  // namespace
 
 // static
 mate::Handle<SharedMemoryWrapper> SharedMemoryWrapper::CreateFrom(
-    v8::Isolate* isolate,
-    const base::SharedMemoryHandle& shared_memory_handle) {
-  return mate::CreateHandle(
-      isolate, new SharedMemoryWrapper(isolate, shared_memory_handle));
+    v8::Isolate* isolate, const AtomMsg_SharedSegment& segment) {
+  return mate::CreateHandle(isolate, new SharedMemoryWrapper(isolate,
+      SharedSegment::Open(segment.handle, segment.size, segment.pooled),
+      segment.size));
 }
 
 // static
 mate::Handle<SharedMemoryWrapper> SharedMemoryWrapper::CreateFrom(
     v8::Isolate* isolate, v8::Local<v8::Value> val) {
-  v8::Local<v8::Context> context = isolate->GetCurrentContext();
-  v8::ValueSerializer serializer(isolate);
-  serializer.WriteHeader();
-  if (!serializer.WriteValue(
-      context, val).FromMaybe(false)) {
-    // error will be thrown by serializer
+  uint32_t size = 0;
+  scoped_refptr<SharedSegment> segment =
+      SegmentSerializer(isolate).Serialize(val, &size);
+  if (!segment)
     return mate::Handle<SharedMemoryWrapper>();
-  }
 
-  std::pair<uint8_t*, size_t> buf = serializer.Release();
-
-  base::Pickle pickle;
-  pickle.WriteInt(buf.second);
-  pickle.WriteBytes(buf.first, buf.second);
-
-  // Create the shared memory object.
-  std::unique_ptr<base::SharedMemory> shared_memory;
-  if (ChildThread::Get()) {
-    shared_memory = ChildThreadImpl::AllocateSharedMemory(pickle.size());
-  } else {
-    shared_memory.reset(new base::SharedMemory);
-
-    base::SharedMemoryCreateOptions options;
-    options.size = pickle.size();
-    options.share_read_only = true;
-    if (!shared_memory->Create(options)) {
-      free(buf.first);
-      return mate::Handle<SharedMemoryWrapper>();
-    }
-  }
+  return mate::CreateHandle(isolate,
+      new SharedMemoryWrapper(isolate, segment, size));
+}
 
-  if (!shared_memory.get() || !shared_memory->Map(pickle.size())) {
-    free(buf.first);
-    return mate::Handle<SharedMemoryWrapper>();
-  }
+SharedMemoryWrapper::SharedMemoryWrapper(v8::Isolate* isolate,
+    scoped_refptr<SharedSegment> segment, uint32_t size)
+        : segment_(segment),
+          size_(size) {
+  Init(isolate);
+}
 
-  // Copy the pickle to shared memory.
-  memcpy(shared_memory->memory(), pickle.data(), pickle.size());
-  free(buf.first);
+SharedMemoryWrapper::~SharedMemoryWrapper() {
+  Close();
+}
 
-  base::SharedMemoryHandle readonly_handle = shared_memory->GetReadOnlyHandle();
-  if (!readonly_handle.IsValid()) {
-    return mate::Handle<SharedMemoryWrapper>();
+bool SharedMemoryWrapper::Share(AtomMsg_SharedSegment* segment) {
+  if (!segment_)
+    return false;
+
+  // Pooled segments are only ever read by the process they were sent to, so
+  // forwarding one sends a copy instead.
+  scoped_refptr<SharedSegment> shared = segment_;
+  if (segment_->pooled() && segment_->received()) {
+    shared = SharedSegment::Create(size_, false);
+    if (!shared)
+      return false;
+    memcpy(shared->payload(), segment_->payload(), size_);
   }
 
-  return CreateFrom(isolate, readonly_handle);
+  segment->handle = shared->Share();
+  segment->size = size_;
+  segment->pooled = shared->pooled();
+  return segment->handle.IsValid();
 }
 
-SharedMemoryWrapper::SharedMemoryWrapper(v8::Isolate* isolate,
-    const base::SharedMemoryHandle& shared_memory_handle)
-        : shared_memory_(new base::SharedMemory(shared_memory_handle, true)),
-          isolate_(isolate) {
-  Init(isolate);
+void SharedMemoryWrapper::Close() {
+  if (!segment_)
+    return;
+
+  // Lets the sender reuse the segment.
+  if (segment_->pooled() && segment_->received())
+    segment_->ReleaseReader();
+  segment_ = nullptr;
 }
 
-void SharedMemoryWrapper::Close() {
-  if (shared_memory_.get()) {
-    shared_memory_->Unmap();
-    shared_memory_->Close();
+v8::Local<v8::Value> SharedMemoryWrapper::Memory() {
+  v8::Isolate* isolate = this->isolate();
+  if (!segment_)
+    return v8::Null(isolate);
+
+  // The sending process can still write to a segment it shared, so the
+  // value is parsed from a copy that can not change halfway through.
+  const uint8_t* payload = segment_->payload();
+  std::vector<uint8_t> copy;
+  if (segment_->received()) {
+    copy.assign(payload, payload + size_);
+    payload = copy.data();
   }
-}
 
-SharedMemoryWrapper::~SharedMemoryWrapper() {
-  Close();
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::ValueDeserializer deserializer(isolate, payload, size_);
+  deserializer.SetSupportsLegacyWireFormat(true);
+  v8::Local<v8::Value> data;
+  if (!deserializer.ReadHeader(context).FromMaybe(false) ||
+      !deserializer.ReadValue(context).ToLocal(&data))
+    return v8::Null(isolate);
+  return data;
 }
 
 void SharedMemoryWrapper::BuildPrototype(v8::Isolate* isolate,
@@ -165,7 +209,7 @@ void SharedMemoryWrapper::BuildPrototype(v8::Isolate* isolate,
   prototype->SetClassName(mate::StringToV8(isolate, "SharedMemoryWrapper"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("close", &SharedMemoryWrapper::Close)
-      .SetMethod("memory", &SharedMemoryWrapper::shared_memory);
+      .SetMethod("memory", &SharedMemoryWrapper::Memory);
 }
 
 SharedMemoryBindings::SharedMemoryBindings(extensions::ScriptContext* context)
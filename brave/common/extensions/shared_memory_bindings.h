@@ -5,56 +5,48 @@
 #ifndef BRAVE_COMMON_EXTENSIONS_SHARED_MEMORY_BINDINGS_H_
 #define BRAVE_COMMON_EXTENSIONS_SHARED_MEMORY_BINDINGS_H_
 
-#include <memory>
+#include <stdint.h>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
-#include "base/memory/shared_memory_handle.h"
+#include "base/memory/ref_counted.h"
 #include "extensions/renderer/object_backed_native_handler.h"
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
 #include "v8/include/v8.h"
 
-namespace base {
-class SharedMemory;
-}
-
-namespace mate {
-
-// static
-template<>
-struct Converter<base::SharedMemory*> {
-  static v8::Local<v8::Value> ToV8(
-      v8::Isolate* isolate, base::SharedMemory* val);
-
-  static bool FromV8(v8::Isolate* isolate,
-      v8::Local<v8::Value> val,
-      base::SharedMemory** out);
-};
-
-}  // namespace mate
+struct AtomMsg_SharedSegment;
 
 namespace brave {
 
+class SharedSegment;
+
+// A value serialized into shared memory, for ipc sendShared.
 class SharedMemoryWrapper : public mate::Wrappable<SharedMemoryWrapper> {
  public:
+  // Wraps a segment received from another process.
   static mate::Handle<SharedMemoryWrapper> CreateFrom(
-    v8::Isolate* isolate, const base::SharedMemoryHandle& shared_memory_handle);
+    v8::Isolate* isolate, const AtomMsg_SharedSegment& segment);
+  // Serializes |val|, straight into a pooled segment when there is one.
   static mate::Handle<SharedMemoryWrapper> CreateFrom(
     v8::Isolate* isolate, v8::Local<v8::Value> val);
 
   static void BuildPrototype(v8::Isolate* isolate,
                       v8::Local<v8::FunctionTemplate> prototype);
 
+  // Fills in |segment| to send the value to another process.
+  bool Share(AtomMsg_SharedSegment* segment);
   void Close();
-  base::SharedMemory* shared_memory() const { return shared_memory_.get(); }
+
  private:
   SharedMemoryWrapper(v8::Isolate* isolate,
-      const base::SharedMemoryHandle& shared_memory_handle);
+      scoped_refptr<SharedSegment> segment, uint32_t size);
   ~SharedMemoryWrapper() override;
 
-  std::unique_ptr<base::SharedMemory> shared_memory_;
-  v8::Isolate* isolate_;
+  v8::Local<v8::Value> Memory();
+
+  scoped_refptr<SharedSegment> segment_;
+  uint32_t size_;
 
   DISALLOW_COPY_AND_ASSIGN(SharedMemoryWrapper);
 };
@@ -0,0 +1,295 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/serialized_args.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "base/memory/shared_memory.h"
+#include "brave/common/shared_memory_pool.h"
+#include "content/child/child_thread_impl.h"
+#include "content/public/child/child_thread.h"
+#include "native_mate/converter.h"
+
+#include "atom/common/node_includes.h"
+
+namespace brave {
+
+const size_t kMaxInlineSerializedArgsSize = 64 * 1024;
+
+namespace {
+
+// How an ArrayBufferView was written, followed by its byte length and bytes.
+enum ViewTag : uint32_t {
+  VIEW_UINT8_ARRAY = 0,
+  VIEW_INT8_ARRAY,
+  VIEW_UINT8_CLAMPED_ARRAY,
+  VIEW_INT16_ARRAY,
+  VIEW_UINT16_ARRAY,
+  VIEW_INT32_ARRAY,
+  VIEW_UINT32_ARRAY,
+  VIEW_FLOAT32_ARRAY,
+  VIEW_FLOAT64_ARRAY,
+  VIEW_DATA_VIEW,
+};
+
+ViewTag GetViewTag(v8::Local<v8::ArrayBufferView> view) {
+  if (view->IsInt8Array())
+    return VIEW_INT8_ARRAY;
+  if (view->IsUint8ClampedArray())
+    return VIEW_UINT8_CLAMPED_ARRAY;
+  if (view->IsInt16Array())
+    return VIEW_INT16_ARRAY;
+  if (view->IsUint16Array())
+    return VIEW_UINT16_ARRAY;
+  if (view->IsInt32Array())
+    return VIEW_INT32_ARRAY;
+  if (view->IsUint32Array())
+    return VIEW_UINT32_ARRAY;
+  if (view->IsFloat32Array())
+    return VIEW_FLOAT32_ARRAY;
+  if (view->IsFloat64Array())
+    return VIEW_FLOAT64_ARRAY;
+  if (view->IsDataView())
+    return VIEW_DATA_VIEW;
+  return VIEW_UINT8_ARRAY;
+}
+
+// Returns 0 for unknown tags.
+size_t GetElementSize(uint32_t tag) {
+  switch (tag) {
+    case VIEW_UINT8_ARRAY:
+    case VIEW_INT8_ARRAY:
+    case VIEW_UINT8_CLAMPED_ARRAY:
+    case VIEW_DATA_VIEW:
+      return 1;
+    case VIEW_INT16_ARRAY:
+    case VIEW_UINT16_ARRAY:
+      return 2;
+    case VIEW_INT32_ARRAY:
+    case VIEW_UINT32_ARRAY:
+    case VIEW_FLOAT32_ARRAY:
+      return 4;
+    case VIEW_FLOAT64_ARRAY:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Writes ArrayBufferViews as host objects, so a small Buffer taken from
+// node's pool does not drag the whole pool along.
+class Serializer : public v8::ValueSerializer::Delegate {
+ public:
+  explicit Serializer(v8::Isolate* isolate)
+      : isolate_(isolate),
+        serializer_(isolate, this) {
+    serializer_.SetTreatArrayBufferViewsAsHostObjects(true);
+  }
+
+  bool Serialize(v8::Local<v8::Value> value,
+                 std::pair<uint8_t*, size_t>* buffer) {
+    serializer_.WriteHeader();
+    if (!serializer_.WriteValue(isolate_->GetCurrentContext(), value)
+             .FromMaybe(false))
+      return false;
+    *buffer = serializer_.Release();
+    return true;
+  }
+
+  // v8::ValueSerializer::Delegate:
+  void ThrowDataCloneError(v8::Local<v8::String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
+
+  v8::Maybe<bool> WriteHostObject(v8::Isolate* isolate,
+                                  v8::Local<v8::Object> object) override {
+    if (!object->IsArrayBufferView())
+      return v8::ValueSerializer::Delegate::WriteHostObject(isolate, object);
+
+    v8::Local<v8::ArrayBufferView> view = object.As<v8::ArrayBufferView>();
+    size_t length = view->ByteLength();
+    serializer_.WriteUint32(GetViewTag(view));
+    serializer_.WriteUint32(static_cast<uint32_t>(length));
+    if (length > 0) {
+      v8::ArrayBuffer::Contents contents = view->Buffer()->GetContents();
+      serializer_.WriteRawBytes(
+          static_cast<const uint8_t*>(contents.Data()) + view->ByteOffset(),
+          length);
+    }
+    return v8::Just(true);
+  }
+
+ private:
+  v8::Isolate* isolate_;
+  v8::ValueSerializer serializer_;
+
+  DISALLOW_COPY_AND_ASSIGN(Serializer);
+};
+
+class Deserializer : public v8::ValueDeserializer::Delegate {
+ public:
+  Deserializer(v8::Isolate* isolate,
+               const uint8_t* data,
+               size_t size,
+               bool create_buffers)
+      : isolate_(isolate),
+        deserializer_(isolate, data, size, this),
+        create_buffers_(create_buffers) {}
+
+  v8::MaybeLocal<v8::Value> Deserialize() {
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+    if (!deserializer_.ReadHeader(context).FromMaybe(false))
+      return v8::MaybeLocal<v8::Value>();
+    return deserializer_.ReadValue(context);
+  }
+
+  // v8::ValueDeserializer::Delegate:
+  v8::MaybeLocal<v8::Object> ReadHostObject(v8::Isolate* isolate) override {
+    uint32_t tag = 0;
+    uint32_t length = 0;
+    const void* data = nullptr;
+    if (!deserializer_.ReadUint32(&tag) ||
+        !deserializer_.ReadUint32(&length) ||
+        !deserializer_.ReadRawBytes(length, &data))
+      return ThrowInvalidData();
+
+    size_t element_size = GetElementSize(tag);
+    if (element_size == 0 || length % element_size != 0)
+      return ThrowInvalidData();
+
+    if (tag == VIEW_UINT8_ARRAY && create_buffers_)
+      return node::Buffer::Copy(isolate, static_cast<const char*>(data),
+                                length);
+
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, length);
+    if (length > 0)
+      memcpy(buffer->GetContents().Data(), data, length);
+
+    size_t count = length / element_size;
+    switch (tag) {
+      case VIEW_UINT8_ARRAY:
+        return v8::Uint8Array::New(buffer, 0, count);
+      case VIEW_INT8_ARRAY:
+        return v8::Int8Array::New(buffer, 0, count);
+      case VIEW_UINT8_CLAMPED_ARRAY:
+        return v8::Uint8ClampedArray::New(buffer, 0, count);
+      case VIEW_INT16_ARRAY:
+        return v8::Int16Array::New(buffer, 0, count);
+      case VIEW_UINT16_ARRAY:
+        return v8::Uint16Array::New(buffer, 0, count);
+      case VIEW_INT32_ARRAY:
+        return v8::Int32Array::New(buffer, 0, count);
+      case VIEW_UINT32_ARRAY:
+        return v8::Uint32Array::New(buffer, 0, count);
+      case VIEW_FLOAT32_ARRAY:
+        return v8::Float32Array::New(buffer, 0, count);
+      case VIEW_FLOAT64_ARRAY:
+        return v8::Float64Array::New(buffer, 0, count);
+      default:
+        return v8::DataView::New(buffer, 0, count);
+    }
+  }
+
+ private:
+  v8::MaybeLocal<v8::Object> ThrowInvalidData() {
+    isolate_->ThrowException(v8::Exception::Error(
+        mate::StringToV8(isolate_, "Unable to deserialize cloned data.")));
+    return v8::MaybeLocal<v8::Object>();
+  }
+
+  v8::Isolate* isolate_;
+  v8::ValueDeserializer deserializer_;
+  bool create_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(Deserializer);
+};
+
+bool CopyToSharedMemory(const uint8_t* data,
+                        size_t size,
+                        AtomMsg_SerializedArgs* args) {
+  if (size > std::numeric_limits<uint32_t>::max())
+    return false;
+
+  // Renderers can not create shared memory themselves.
+  std::unique_ptr<base::SharedMemory> shared_memory;
+  if (content::ChildThread::Get()) {
+    shared_memory = content::ChildThreadImpl::AllocateSharedMemory(size);
+  } else {
+    shared_memory.reset(new base::SharedMemory);
+
+    base::SharedMemoryCreateOptions options;
+    options.size = size;
+    options.share_read_only = true;
+    if (!shared_memory->Create(options))
+      return false;
+  }
+
+  if (!shared_memory.get() || !shared_memory->Map(size))
+    return false;
+  memcpy(shared_memory->memory(), data, size);
+
+  args->shared_data = shared_memory->GetReadOnlyHandle();
+  args->shared_data_size = static_cast<uint32_t>(size);
+  return args->shared_data.IsValid();
+}
+
+}  // namespace
+
+bool SerializeArgs(v8::Isolate* isolate,
+                   v8::Local<v8::Value> value,
+                   AtomMsg_SerializedArgs* args) {
+  v8::TryCatch try_catch(isolate);
+  Serializer serializer(isolate);
+  std::pair<uint8_t*, size_t> buffer;
+  if (!serializer.Serialize(value, &buffer))
+    return false;
+
+  bool result = true;
+  if (buffer.second <= kMaxInlineSerializedArgsSize)
+    args->data.assign(buffer.first, buffer.first + buffer.second);
+  else
+    result = CopyToSharedMemory(buffer.first, buffer.second, args);
+  free(buffer.first);
+  return result;
+}
+
+v8::MaybeLocal<v8::Value> DeserializeArgs(v8::Isolate* isolate,
+                                          const AtomMsg_SerializedArgs& args,
+                                          bool create_buffers) {
+  const uint8_t* data = args.data.data();
+  size_t size = args.data.size();
+
+  // Takes ownership of the handle, so the segment is released once read.
+  // The sender may still be able to write to it, so the value is parsed from
+  // a copy.
+  std::vector<uint8_t> shared_data;
+  if (args.shared_data.IsValid()) {
+    base::SharedMemory shared_memory(args.shared_data, true);
+    if (!MapReceivedSharedMemory(&shared_memory, args.shared_data_size))
+      return v8::MaybeLocal<v8::Value>();
+    const uint8_t* memory =
+        static_cast<const uint8_t*>(shared_memory.memory());
+    shared_data.assign(memory, memory + args.shared_data_size);
+    data = shared_data.data();
+    size = shared_data.size();
+  }
+
+  v8::EscapableHandleScope handle_scope(isolate);
+  v8::TryCatch try_catch(isolate);
+  Deserializer deserializer(isolate, data, size, create_buffers);
+  v8::Local<v8::Value> value;
+  if (!deserializer.Deserialize().ToLocal(&value))
+    return v8::MaybeLocal<v8::Value>();
+  return handle_scope.Escape(value);
+}
+
+}  // namespace brave
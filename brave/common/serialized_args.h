@@ -0,0 +1,38 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_SERIALIZED_ARGS_H_
+#define BRAVE_COMMON_SERIALIZED_ARGS_H_
+
+#include <stddef.h>
+
+#include "v8/include/v8.h"
+
+struct AtomMsg_SerializedArgs;
+
+namespace brave {
+
+// Serialized values up to this size are copied into the IPC message, larger
+// ones are put in a read-only shared memory segment.
+extern const size_t kMaxInlineSerializedArgsSize;
+
+// Writes |value| with v8::ValueSerializer, the same format worker messages
+// use. ArrayBufferViews, node Buffers included, only copy the bytes they
+// view. Returns false, with no exception pending, if |value| can not be
+// cloned, e.g. because it holds functions or DOM objects.
+bool SerializeArgs(v8::Isolate* isolate,
+                   v8::Local<v8::Value> value,
+                   AtomMsg_SerializedArgs* args);
+
+// Reads a value written by SerializeArgs in the current context of
+// |isolate|, returning an empty handle with no exception pending if the data
+// is invalid. Uint8Arrays come back as node Buffers if |create_buffers| is
+// true, which needs node in the current context.
+v8::MaybeLocal<v8::Value> DeserializeArgs(v8::Isolate* isolate,
+                                          const AtomMsg_SerializedArgs& args,
+                                          bool create_buffers);
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_SERIALIZED_ARGS_H_
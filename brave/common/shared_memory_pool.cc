@@ -0,0 +1,182 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/shared_memory_pool.h"
+
+#include <utility>
+
+#include "base/atomicops.h"
+#include "base/lazy_instance.h"
+#include "base/memory/shared_memory.h"
+#include "build/build_config.h"
+#include "content/child/child_thread_impl.h"
+#include "content/public/child/child_thread.h"
+
+namespace brave {
+
+namespace {
+
+// Payload sizes of the pooled segments, each class four times the previous.
+const size_t kSmallestSizeClass = 64 * 1024;
+
+// Segments that are never released, e.g. because the message was dropped,
+// stay busy forever, so each class is capped.
+const size_t kMaxSegmentsPerClass = 4;
+
+base::LazyInstance<SharedMemoryPool>::Leaky g_shared_memory_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+struct SharedSegment::Header {
+  // Processes that have been sent a pooled segment and not released it yet.
+  base::subtle::Atomic32 readers;
+  uint32_t reserved;
+};
+
+SharedSegment::SharedSegment(std::unique_ptr<base::SharedMemory> memory,
+                             size_t capacity,
+                             bool pooled,
+                             bool received)
+    : memory_(std::move(memory)),
+      capacity_(capacity),
+      pooled_(pooled),
+      received_(received) {
+}
+
+SharedSegment::~SharedSegment() {
+}
+
+// static
+scoped_refptr<SharedSegment> SharedSegment::Create(size_t capacity,
+                                                   bool pooled) {
+  size_t size = sizeof(Header) + capacity;
+  if (size < capacity)
+    return nullptr;
+
+  // Renderers can not create shared memory themselves.
+  std::unique_ptr<base::SharedMemory> memory;
+  if (content::ChildThread::Get()) {
+    memory = content::ChildThreadImpl::AllocateSharedMemory(size);
+  } else {
+    memory.reset(new base::SharedMemory);
+
+    base::SharedMemoryCreateOptions options;
+    options.size = size;
+    options.share_read_only = true;
+    if (!memory->Create(options))
+      return nullptr;
+  }
+
+  if (!memory.get() || !memory->Map(size))
+    return nullptr;
+
+  scoped_refptr<SharedSegment> segment(
+      new SharedSegment(std::move(memory), capacity, pooled, false));
+  base::subtle::NoBarrier_Store(&segment->header()->readers, 0);
+  return segment;
+}
+
+// static
+scoped_refptr<SharedSegment> SharedSegment::Open(
+    const base::SharedMemoryHandle& handle, uint32_t size, bool pooled) {
+  std::unique_ptr<base::SharedMemory> memory(
+      new base::SharedMemory(handle, !pooled));
+  if (!MapReceivedSharedMemory(memory.get(), sizeof(Header) + size))
+    return nullptr;
+
+  return make_scoped_refptr(
+      new SharedSegment(std::move(memory), size, pooled, true));
+}
+
+uint8_t* SharedSegment::payload() const {
+  return static_cast<uint8_t*>(memory_->memory()) + sizeof(Header);
+}
+
+base::SharedMemoryHandle SharedSegment::Share() {
+  if (!pooled_) {
+    // Received segments were already shared read-only.
+    return received_ ? memory_->handle().Duplicate()
+                     : memory_->GetReadOnlyHandle();
+  }
+
+  if (received_)
+    return base::SharedMemoryHandle();
+
+  base::subtle::Barrier_AtomicIncrement(&header()->readers, 1);
+  base::SharedMemoryHandle handle = memory_->handle().Duplicate();
+  if (!handle.IsValid())
+    ReleaseReader();
+  return handle;
+}
+
+void SharedSegment::ReleaseReader() {
+  DCHECK(pooled_);
+  base::subtle::Barrier_AtomicIncrement(&header()->readers, -1);
+}
+
+bool SharedSegment::HasReaders() const {
+  return base::subtle::Acquire_Load(&header()->readers) > 0;
+}
+
+SharedSegment::Header* SharedSegment::header() const {
+  return static_cast<Header*>(memory_->memory());
+}
+
+bool MapReceivedSharedMemory(base::SharedMemory* memory, size_t size) {
+#if defined(OS_POSIX)
+  // A mapping past the end of the region would only fault once it is read.
+  size_t region_size = 0;
+  if (!base::SharedMemory::GetSizeFromSharedMemoryHandle(memory->handle(),
+                                                         &region_size) ||
+      region_size < size)
+    return false;
+#endif
+  // Windows refuses to map views larger than the region.
+  return memory->Map(size);
+}
+
+SharedMemoryPool::SharedMemoryPool() {
+}
+
+SharedMemoryPool::~SharedMemoryPool() {
+}
+
+// static
+SharedMemoryPool* SharedMemoryPool::GetInstance() {
+  return g_shared_memory_pool.Pointer();
+}
+
+scoped_refptr<SharedSegment> SharedMemoryPool::Acquire(size_t size) {
+  if (!content::ChildThread::Get())
+    return nullptr;
+
+  size_t size_class = 0;
+  size_t capacity = kSmallestSizeClass;
+  while (capacity < size) {
+    if (++size_class == kSizeClassCount)
+      return nullptr;
+    capacity *= 4;
+  }
+
+  base::AutoLock auto_lock(lock_);
+  std::vector<scoped_refptr<SharedSegment>>& segments = segments_[size_class];
+
+  // A segment is free once the pool holds the only reference to it and the
+  // browser has released it.
+  for (const auto& segment : segments) {
+    if (segment->HasOneRef() && !segment->HasReaders())
+      return segment;
+  }
+
+  if (segments.size() == kMaxSegmentsPerClass)
+    return nullptr;
+
+  scoped_refptr<SharedSegment> segment = SharedSegment::Create(capacity, true);
+  if (segment)
+    segments.push_back(segment);
+  return segment;
+}
+
+}  // namespace brave
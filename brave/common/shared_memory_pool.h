@@ -0,0 +1,106 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_SHARED_MEMORY_POOL_H_
+#define BRAVE_COMMON_SHARED_MEMORY_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory_handle.h"
+#include "base/synchronization/lock.h"
+
+namespace base {
+class SharedMemory;
+}
+
+namespace brave {
+
+// A mapped shared memory segment that holds one serialized value. The
+// payload follows a small header that counts the processes still reading a
+// pooled segment, so the writer knows when it can be reused without waiting
+// for a reply message.
+class SharedSegment : public base::RefCountedThreadSafe<SharedSegment> {
+ public:
+  // Creates a segment with room for |capacity| payload bytes. Pooled
+  // segments are shared writable, so that readers can release them.
+  static scoped_refptr<SharedSegment> Create(size_t capacity, bool pooled);
+
+  // Maps a segment received from another process, |size| being the length
+  // of the payload. Returns null if the region is smaller than that.
+  static scoped_refptr<SharedSegment> Open(
+      const base::SharedMemoryHandle& handle, uint32_t size, bool pooled);
+
+  uint8_t* payload() const;
+  size_t capacity() const { return capacity_; }
+  bool pooled() const { return pooled_; }
+  bool received() const { return received_; }
+
+  // Duplicates the handle to send to another process, which counts as a
+  // reader of a pooled segment until it calls ReleaseReader(). Pooled
+  // segments received from another process can not be shared again.
+  base::SharedMemoryHandle Share();
+
+  // Called by the reading process once it is done with a pooled segment.
+  void ReleaseReader();
+
+  bool HasReaders() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedSegment>;
+  struct Header;
+
+  SharedSegment(std::unique_ptr<base::SharedMemory> memory,
+                size_t capacity,
+                bool pooled,
+                bool received);
+  ~SharedSegment();
+
+  Header* header() const;
+
+  std::unique_ptr<base::SharedMemory> memory_;
+  size_t capacity_;
+  bool pooled_;
+  bool received_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedSegment);
+};
+
+// Maps the first |size| bytes of |memory| received from another process.
+// |size| comes from that process as well, so this fails instead of mapping
+// past the end of the region.
+bool MapReceivedSharedMemory(base::SharedMemory* memory, size_t size);
+
+// Pre-mapped segments in a few size classes, reused once the process they
+// were sent to has released them. Only renderers pool their segments: they
+// only ever send them to the browser, while a segment the browser reused
+// for another renderer could still be mapped by the first one.
+class SharedMemoryPool {
+ public:
+  SharedMemoryPool();
+  ~SharedMemoryPool();
+
+  static SharedMemoryPool* GetInstance();
+
+  // Returns an unused pooled segment with room for at least |size| bytes,
+  // or null if |size| is too large or there is no pooling in this process.
+  scoped_refptr<SharedSegment> Acquire(size_t size);
+
+ private:
+  static const size_t kSizeClassCount = 5;
+
+  base::Lock lock_;
+  std::vector<scoped_refptr<SharedSegment>> segments_[kSizeClassCount];
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryPool);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_SHARED_MEMORY_POOL_H_
@@ -9,6 +9,7 @@
 
 #include "atom/browser/api/atom_api_app.h"
 #include "brave/common/workers/v8_worker_thread.h"
+#include "brave/common/workers/worker_message.h"
 #include "content/child/worker_thread_registry.h"
 #include "content/public/browser/browser_thread.h"
 #include "extensions/renderer/script_context.h"
@@ -31,16 +32,12 @@ bool SetReadOnlyProperty(v8::Local<v8::Context> context,
       static_cast<v8::PropertyAttribute>(v8::ReadOnly)));
 }
 
-void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
+void OnMessageInternal(std::unique_ptr<WorkerMessage> buf) {
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
 
-  v8::ValueDeserializer deserializer(
-      isolate, buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(context).FromMaybe(false)) {
-    v8::Local<v8::Value> message =
-        deserializer.ReadValue(context).ToLocalChecked();
+  v8::Local<v8::Value> message;
+  if (buf->Deserialize(isolate).ToLocal(&message)) {
     v8::Local<v8::Object> global = context->Global();
     v8::Local<v8::Value> onmessage =
         global->Get(context, v8::String::NewFromUtf8(isolate, "onmessage",
@@ -54,7 +51,6 @@ void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
       (void)onmessage_fun->Call(context, global, 1, argv);
     }
   }
-  free(buf.first);
 }
 
 }  // namespace
@@ -180,20 +176,16 @@ void WorkerBindings::Close(
 }
 
 void WorkerBindings::PostMessageOnUIThread(
-    const std::pair<uint8_t*, size_t>& buf) {
-  v8::ValueDeserializer deserializer(
-      worker_->app()->isolate(), buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(
-      worker_->app()->isolate()->GetCurrentContext()).FromMaybe(false)) {
-    v8::Local<v8::Value> val = deserializer.ReadValue(
-        worker_->app()->isolate()->GetCurrentContext()).ToLocalChecked();
+    std::unique_ptr<WorkerMessage> buf) {
+  v8::Isolate* isolate = worker_->app()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> val;
+  if (buf->Deserialize(isolate).ToLocal(&val)) {
     worker_->app()->Emit("worker-post-message", worker_->GetThreadId(), val);
   } else {
     worker_->app()->Emit("worker-onerror", worker_->GetThreadId(),
         "`postMessage` could not deserialize message buffer");
   }
-  free(buf.first);
 }
 
 void WorkerBindings::PostMessage(
@@ -204,46 +196,37 @@ void WorkerBindings::PostMessage(
     return;
   }
 
-  if (args.Length() > 1) {
-    context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`transferList` is not supported yet"));
-    return;
-  }
-
-  v8::ValueSerializer serializer(context()->isolate());
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      context()->v8_context(), args[0]).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
-
+  std::string error;
+  std::unique_ptr<WorkerMessage> buffer = WorkerMessage::Create(
+      context()->isolate(), args[0], args[1], &error);
+  if (buffer) {
     BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
         base::Bind(&WorkerBindings::PostMessageOnUIThread,
                     weak_ptr_factory_.GetWeakPtr(),
-                    std::move(buffer)));
+                    base::Passed(&buffer)));
   } else {
     context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`postMessage` could not serialize message"));
+        context()->isolate(), ("`postMessage` " + error).c_str()));
   }
 }
 
 // static
 bool WorkerBindings::OnMessage(v8::Isolate* isolate,
                                 base::PlatformThreadId thread_id,
-                                v8::Local<v8::Value> message) {
-  v8::ValueSerializer serializer(isolate);
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      isolate->GetCurrentContext(), message).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
-
-    base::TaskRunner* task_runner =
-        content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
-    task_runner->PostTask(FROM_HERE,
-        base::Bind(&OnMessageInternal,
-        std::move(buffer)));
-    return true;
-  }
-  return false;
+                                v8::Local<v8::Value> message,
+                                v8::Local<v8::Value> transfer_list,
+                                std::string* error) {
+  std::unique_ptr<WorkerMessage> buffer =
+      WorkerMessage::Create(isolate, message, transfer_list, error);
+  if (!buffer)
+    return false;
+
+  base::TaskRunner* task_runner =
+      content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
+  task_runner->PostTask(FROM_HERE,
+      base::Bind(&OnMessageInternal,
+      base::Passed(&buffer)));
+  return true;
 }
 
 }  // namespace brave
@@ -0,0 +1,102 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/worker_message.h"
+
+#include <algorithm>
+
+#include "gin/array_buffer.h"
+
+namespace brave {
+
+WorkerMessage::WorkerMessage() : buffer_(nullptr, 0) {
+}
+
+WorkerMessage::~WorkerMessage() {
+  free(buffer_.first);
+  for (const auto& array_buffer : array_buffers_)
+    gin::ArrayBufferAllocator::SharedInstance()->Free(array_buffer.first,
+                                                      array_buffer.second);
+}
+
+// static
+std::unique_ptr<WorkerMessage> WorkerMessage::Create(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> message,
+    v8::Local<v8::Value> transfer_list,
+    std::string* error) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+  std::vector<v8::Local<v8::ArrayBuffer>> transferred;
+  if (!transfer_list.IsEmpty() && !transfer_list->IsUndefined()) {
+    if (!transfer_list->IsArray()) {
+      *error = "`transferList` must be an Array";
+      return nullptr;
+    }
+    v8::Local<v8::Array> list = transfer_list.As<v8::Array>();
+    for (uint32_t i = 0; i < list->Length(); ++i) {
+      v8::Local<v8::Value> value;
+      if (!list->Get(context, i).ToLocal(&value) || !value->IsArrayBuffer()) {
+        *error = "`transferList` may only contain ArrayBuffers";
+        return nullptr;
+      }
+      v8::Local<v8::ArrayBuffer> array_buffer = value.As<v8::ArrayBuffer>();
+      // External buffers are owned by someone else, e.g. a node Buffer pool.
+      if (array_buffer->IsExternal() || !array_buffer->IsNeuterable()) {
+        *error = "`transferList` contains an ArrayBuffer that can not be "
+                 "transferred";
+        return nullptr;
+      }
+      if (std::find(transferred.begin(), transferred.end(), array_buffer) !=
+          transferred.end()) {
+        *error = "`transferList` contains the same ArrayBuffer twice";
+        return nullptr;
+      }
+      transferred.push_back(array_buffer);
+    }
+  }
+
+  v8::ValueSerializer serializer(isolate);
+  serializer.WriteHeader();
+  for (size_t i = 0; i < transferred.size(); ++i)
+    serializer.TransferArrayBuffer(static_cast<uint32_t>(i), transferred[i]);
+  if (!serializer.WriteValue(context, message).FromMaybe(false)) {
+    *error = "could not serialize message";
+    return nullptr;
+  }
+
+  std::unique_ptr<WorkerMessage> result(new WorkerMessage);
+  result->buffer_ = serializer.Release();
+
+  // Only detach once serialization can no longer fail.
+  for (const auto& array_buffer : transferred) {
+    v8::ArrayBuffer::Contents contents = array_buffer->Externalize();
+    array_buffer->Neuter();
+    result->array_buffers_.push_back(
+        std::make_pair(contents.Data(), contents.ByteLength()));
+  }
+  return result;
+}
+
+v8::MaybeLocal<v8::Value> WorkerMessage::Deserialize(v8::Isolate* isolate) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::ValueDeserializer deserializer(isolate, buffer_.first, buffer_.second);
+  deserializer.SetSupportsLegacyWireFormat(true);
+  if (!deserializer.ReadHeader(context).FromMaybe(false))
+    return v8::MaybeLocal<v8::Value>();
+
+  for (size_t i = 0; i < array_buffers_.size(); ++i) {
+    deserializer.TransferArrayBuffer(
+        static_cast<uint32_t>(i),
+        v8::ArrayBuffer::New(isolate, array_buffers_[i].first,
+                             array_buffers_[i].second,
+                             v8::ArrayBufferCreationMode::kInternalized));
+  }
+  // The receiving isolate owns the backing stores now.
+  array_buffers_.clear();
+
+  return deserializer.ReadValue(context);
+}
+
+}  // namespace brave
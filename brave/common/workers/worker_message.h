@@ -0,0 +1,54 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+#define BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+// A message posted between a worker and the app.
+//
+// The value is written with v8::ValueSerializer. ArrayBuffers listed in the
+// transfer list are not copied: they are detached from the sender and their
+// backing stores travel with the message, to be adopted by the receiving
+// isolate. All isolates share gin's ArrayBufferAllocator, so a backing store
+// can be freed by the isolate that adopts it.
+class WorkerMessage {
+ public:
+  // Serializes |message| and takes the buffers in |transfer_list|, which is
+  // undefined or an Array of ArrayBuffers. Returns nullptr with |error| set
+  // on failure, in which case no buffer has been detached.
+  static std::unique_ptr<WorkerMessage> Create(
+      v8::Isolate* isolate,
+      v8::Local<v8::Value> message,
+      v8::Local<v8::Value> transfer_list,
+      std::string* error);
+
+  ~WorkerMessage();
+
+  // Deserializes the message in the current context of |isolate|, adopting
+  // the transferred buffers.
+  v8::MaybeLocal<v8::Value> Deserialize(v8::Isolate* isolate);
+
+ private:
+  WorkerMessage();
+
+  std::pair<uint8_t*, size_t> buffer_;
+  // Backing stores not yet adopted by a receiver, owned by the message.
+  std::vector<std::pair<void*, size_t>> array_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerMessage);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
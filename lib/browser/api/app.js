@@ -9,6 +9,7 @@ module.exports = app
 const electron = require('electron')
 const {deprecate, Menu} = electron
 const {EventEmitter} = require('events')
+const WorkerPool = require('../worker-pool')
 
 Object.setPrototypeOf(App.prototype, EventEmitter.prototype)
 
@@ -66,18 +67,39 @@ function Worker (module_name) {
   this.onmessage = null
 }
 
+// Started workers by a monotonic id. The worker events of the app carry
+// thread ids, which the OS can reuse once a worker has stopped.
+const workers = new Map()
+let nextWorkerId = 1
+
+// Finds the oldest started worker on |threadId|, whose events come first.
+function getWorker (threadId) {
+  for (const worker of workers.values()) {
+    if (worker.threadId === threadId) return worker
+  }
+  return null
+}
+
 Worker.prototype.start = function (cb) {
   cb && this.once('start', cb)
-  this.id = app._startWorker(this.module_name)
+  this.id = nextWorkerId++
+  this.threadId = app._startWorker(this.module_name)
+  if (this.threadId === -1) {
+    process.nextTick(() => this.emit('stop', {}))
+    return
+  }
+  workers.set(this.id, this)
 }
 
-Worker.prototype.postMessage = function (message) {
+Worker.prototype.postMessage = function (message, transferList) {
   const evt = {data: message}
-  app._postMessage(this.id, evt)
+  app._postMessage(this.threadId, evt, transferList)
 }
 
 Worker.prototype.terminate = function () {
-  app.stopWorker(this.id)
+  // The thread id may already belong to another worker.
+  if (!workers.has(this.id)) return
+  app.stopWorker(this.threadId)
 }
 
 Object.defineProperty(Worker.prototype, 'onerror', {
@@ -90,39 +112,57 @@ Object.defineProperty(Worker.prototype, 'onerror', {
 
 Object.setPrototypeOf(Worker.prototype, EventEmitter.prototype)
 
-app.createWorker = function (module_name) {
-  const worker = new Worker(module_name)
-
-  // It is always safe to call the worker methods because
-  // WorkerThreadRegistry will return a dummy task runner
-  app.on('worker-start', (e, worker_id) => {
-    if (worker.id === worker_id) {
-      worker.emit('start', {})
-    }
-  })
-  app.on('worker-stop', (e, worker_id) => {
-    if (worker.id === worker_id) {
-      worker.emit('stop', {})
-    }
-  })
-  app.on('worker-post-message', (e, worker_id, message) => {
-    if (worker.id === worker_id) {
-      const event = {data: message}
-      worker.emit('message', event)
-      worker.onmessage && worker.onmessage(event)
-    }
-  })
-  app.on('worker-onerror', (e, worker_id, message, stack) => {
+// It is always safe to call the worker methods because
+// WorkerThreadRegistry will return a dummy task runner
+app.on('worker-start', (e, worker_id) => {
+  const worker = getWorker(worker_id)
+  if (worker) {
+    worker.emit('start', {})
+  }
+})
+app.on('worker-stop', (e, worker_id) => {
+  const worker = getWorker(worker_id)
+  if (worker) {
+    workers.delete(worker.id)
+    worker.emit('stop', {})
+  }
+})
+app.on('worker-post-message', (e, worker_id, message) => {
+  const worker = getWorker(worker_id)
+  if (worker) {
+    const event = {data: message}
+    worker.emit('message', event)
+    worker.onmessage && worker.onmessage(event)
+  }
+})
+app.on('worker-onerror', (e, worker_id, message, stack) => {
+  const worker = getWorker(worker_id)
+  if (worker) {
     worker.lastError = message
-    if (worker.id === worker_id) {
-      worker.onerror && worker.onerror(message, stack)
-    }
-  })
-  app.on('app-post-message', (e, message) => {
-    worker.postMessage(message)
-  })
+    worker.onerror && worker.onerror(message, stack)
+  }
+})
+app.on('app-post-message', (e, message) => {
+  for (const worker of workers.values()) {
+    if (!worker.pooled) worker.postMessage(message)
+  }
+})
+
+app.createWorker = function (module_name) {
+  return new Worker(module_name)
+}
 
-  return worker
+app.createWorkerPool = function (module_name, options) {
+  const pool = new WorkerPool((name) => {
+    const worker = new Worker(name)
+    // Pooled workers only receive their tasks.
+    worker.pooled = true
+    return worker
+  }, module_name, options)
+  pool.on('metrics', (metrics) => {
+    app.emit('worker-pool-metrics', pool, metrics)
+  })
+  return pool
 }
 
 app.allowNTLMCredentialsForAllDomains = function (allow) {
@@ -1,6 +1,6 @@
 const {EventEmitter} = require('events')
 const {app} = require('electron')
-const {fromPartition, getAllSessions, Session} = process.atomBinding('session')
+const {fromPartition, getAllSessions, getSharedNetworkSessionInfo, Session} = process.atomBinding('session')
 
 // Public API.
 Object.defineProperties(exports, {
@@ -15,6 +15,10 @@ Object.defineProperties(exports, {
   getAllSessions: {
     enumerable: true,
     value: getAllSessions
+  },
+  getSharedNetworkSessionInfo: {
+    enumerable: true,
+    value: getSharedNetworkSessionInfo
   }
 })
 
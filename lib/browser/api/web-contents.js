@@ -184,7 +184,13 @@ WebContents.prototype._init = function () {
   this.on('ipc-message-sync', function (event, [channel, ...args]) {
     Object.defineProperty(event, 'returnValue', {
       set: function (value) {
-        return event.sendReply(JSON.stringify(value))
+        try {
+          return event.sendReply(value)
+        } catch (error) {
+          // Values that can not be cloned are sent the way JSON would.
+          const json = JSON.stringify(value)
+          return event.sendReply(json === undefined ? null : JSON.parse(json))
+        }
       },
       get: function () {}
     })
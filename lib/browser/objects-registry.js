@@ -8,11 +8,11 @@ class ObjectsRegistry {
 
     // Stores all objects by ref-counting.
     // (id) => {object, count}
-    this.storage = {}
+    this.storage = new Map()
 
     // Stores the IDs of objects referenced by WebContents.
-    // (webContentsId) => [id]
-    this.owners = {}
+    // (webContentsId) => Set<id>
+    this.owners = new Map()
   }
 
   // Register a new object and return its assigned ID. If the object is already
@@ -23,9 +23,10 @@ class ObjectsRegistry {
 
     // Add object to the set of referenced objects.
     let webContentsId = webContents.getId()
-    let owner = this.owners[webContentsId]
+    let owner = this.owners.get(webContentsId)
     if (!owner) {
-      owner = this.owners[webContentsId] = new Set()
+      owner = new Set()
+      this.owners.set(webContentsId, owner)
       // Clear the storage when webContents is reloaded/navigated.
       webContents.once('will-destroy', () => {
         this.clear(webContentsId)
@@ -34,14 +35,15 @@ class ObjectsRegistry {
     if (!owner.has(id)) {
       owner.add(id)
       // Increase reference count if not referenced before.
-      this.storage[id].count++
+      this.storage.get(id).count++
     }
     return id
   }
 
   // Get an object according to its ID.
   get (id) {
-    return this.storage[id].object
+    const pointer = this.storage.get(id)
+    return pointer ? pointer.object : undefined
   }
 
   // Dereference an object according to its ID.
@@ -50,24 +52,23 @@ class ObjectsRegistry {
     if (webContentsId === id)
       return
 
-    // Dereference from the storage.
-    this.dereference(id)
-
-    // Also remove the reference in owner.
-    let owner = this.owners[webContentsId]
-    if (owner) {
-      owner.delete(id)
+    // Also remove the reference in owner, only dereferencing objects the
+    // owner actually holds.
+    let owner = this.owners.get(webContentsId)
+    if (owner && owner.delete(id)) {
+      this.dereference(id)
     }
   }
 
-  // Clear all references to objects refrenced by the WebContents.
+  // Clear all references to objects refrenced by the WebContents. This stays
+  // linear in the number of objects the WebContents holds, each of them has
+  // to be dereferenced.
   clear (webContentsId) {
-    let owner = this.owners[webContentsId]
+    let owner = this.owners.get(webContentsId)
     if (!owner) return
 
+    this.owners.delete(webContentsId)
     for (let id of owner) this.dereference(id)
-
-    delete this.owners[webContentsId]
   }
 
   // Private: Saves the object into storage and assigns an ID for it.
@@ -75,10 +76,10 @@ class ObjectsRegistry {
     let id = v8Util.getHiddenValue(object, 'atomId')
     if (!id) {
       id = ++this.nextId
-      this.storage[id] = {
+      this.storage.set(id, {
         count: 0,
         object: object
-      }
+      })
       v8Util.setHiddenValue(object, 'atomId', id)
     }
     return id
@@ -86,14 +87,14 @@ class ObjectsRegistry {
 
   // Private: Dereference the object from store.
   dereference (id) {
-    let pointer = this.storage[id]
+    let pointer = this.storage.get(id)
     if (pointer == null) {
       return
     }
     pointer.count -= 1
     if (pointer.count === 0) {
       v8Util.deleteHiddenValue(pointer.object, 'atomId')
-      return delete this.storage[id]
+      this.storage.delete(id)
     }
   }
 }
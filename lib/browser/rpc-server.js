@@ -42,14 +42,48 @@ let getObjectMembers = function (object) {
   })
 }
 
-// Return the description of object's prototype.
-let getObjectPrototype = function (object) {
-  let proto = Object.getPrototypeOf(object)
+// Prototypes are described once and then referred to by {id, version},
+// renderers cache the descriptions. A prototype is described again with a
+// new version when its number of own members or its own prototype changes,
+// e.g. after a mixin or a lazy method install.
+// prototype => {id, version, count, parent, description}
+const prototypeInfos = new WeakMap()
+// id => prototype, held weakly so collected prototypes release their ids.
+const prototypeObjects = v8Util.createIDWeakMap()
+let nextPrototypeId = 0
+
+// Return the {id, version} of the current description of proto.
+let describePrototype = function (proto) {
   if (proto === null || proto === Object.prototype) return null
-  return {
-    members: getObjectMembers(proto),
-    proto: getObjectPrototype(proto)
+  const parent = describePrototype(Object.getPrototypeOf(proto))
+  const count = Object.getOwnPropertyNames(proto).length
+  let info = prototypeInfos.get(proto)
+  if (info === undefined) {
+    info = {id: ++nextPrototypeId, version: 0}
+    prototypeInfos.set(proto, info)
+    prototypeObjects.set(info.id, proto)
+  }
+  const parentChanged = parent === null
+    ? info.parent !== null
+    : info.parent == null || info.parent.id !== parent.id ||
+      info.parent.version !== parent.version
+  if (info.description === undefined || info.count !== count || parentChanged) {
+    info.version++
+    info.count = count
+    info.parent = parent
+    info.description = {
+      id: info.id,
+      version: info.version,
+      members: getObjectMembers(proto),
+      proto: parent
+    }
   }
+  return {id: info.id, version: info.version}
+}
+
+// Return the {id, version} of the description of object's prototype.
+let getObjectPrototype = function (object) {
+  return describePrototype(Object.getPrototypeOf(object))
 }
 
 // Convert a real value into meta data.
@@ -227,6 +261,59 @@ const callFunction = function (event, func, caller, args) {
   }
 }
 
+// Run a batch of member operations, calling |callback| with the meta data of
+// every result once they are all done. An operation may work on the result
+// of an earlier one in the same batch instead of a registered object.
+const runOperations = function (sender, operations, callback) {
+  const values = []
+  const results = []
+  let index = 0
+
+  const settle = function (value, meta) {
+    values.push(value)
+    results.push(meta)
+  }
+
+  const next = function () {
+    while (index < operations.length) {
+      const operation = operations[index++]
+      try {
+        const obj = operation.result != null
+          ? values[operation.result]
+          : objectsRegistry.get(operation.id)
+        if (operation.type === 'get') {
+          const value = obj[operation.name]
+          settle(value, valueToMeta(sender, value))
+        } else if (operation.type === 'set') {
+          obj[operation.name] = unwrapArgs(sender, [operation.value])[0]
+          settle(undefined, valueToMeta(sender, undefined))
+        } else if (operation.type === 'call') {
+          const func = obj[operation.name]
+          const args = unwrapArgs(sender, operation.args)
+          const funcMarkedAsync = v8Util.getHiddenValue(func, 'asynchronous')
+          if (funcMarkedAsync && typeof args[args.length - 1] !== 'function') {
+            // Wait for the result before running the rest of the batch.
+            args.push(function (ret) {
+              settle(ret, valueToMeta(sender, ret, true))
+              next()
+            })
+            func.apply(obj, args)
+            return
+          }
+          const ret = func.apply(obj, args)
+          settle(ret, valueToMeta(sender, ret, true))
+        } else {
+          throw new TypeError(`Unknown operation: ${operation.type}`)
+        }
+      } catch (error) {
+        settle(undefined, exceptionToMeta(error))
+      }
+    }
+    callback(results)
+  }
+  next()
+}
+
 ipcMain.on('ELECTRON_BROWSER_REQUIRE', function (event, module) {
   try {
     event.returnValue = valueToMeta(event.sender, process.mainModule.require(module))
@@ -346,6 +433,35 @@ ipcMain.on('ELECTRON_BROWSER_MEMBER_GET', function (event, id, name) {
   }
 })
 
+ipcMain.on('ELECTRON_BROWSER_BATCH', function (event, operations) {
+  runOperations(event.sender, operations, function (results) {
+    event.returnValue = results
+  })
+})
+
+ipcMain.on('ELECTRON_BROWSER_BATCH_ASYNC', function (event, requestId, operations) {
+  const sender = event.sender
+  runOperations(sender, operations, function (results) {
+    if (!sender.isDestroyed()) {
+      sender.send('ELECTRON_RENDERER_BATCH_RESPONSE', requestId, results)
+    }
+  })
+})
+
+// Returns the current descriptions of a prototype chain, the renderer caches
+// them.
+ipcMain.on('ELECTRON_BROWSER_PROTOTYPE', function (event, id) {
+  const chain = []
+  if (prototypeObjects.has(id)) {
+    let proto = prototypeObjects.get(id)
+    describePrototype(proto)
+    for (; proto !== null && proto !== Object.prototype; proto = Object.getPrototypeOf(proto)) {
+      chain.push(prototypeInfos.get(proto).description)
+    }
+  }
+  event.returnValue = chain
+})
+
 ipcMain.on('ELECTRON_BROWSER_DEREFERENCE', function (event, id) {
   objectsRegistry.remove(event.sender.getId(), id)
 })
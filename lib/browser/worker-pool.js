@@ -0,0 +1,204 @@
+'use strict'
+
+const {EventEmitter} = require('events')
+const os = require('os')
+
+// Runs tasks on a fixed set of warm workers that all load the same module.
+//
+// A task is posted to an idle worker as a message and settles with the first
+// message that worker posts back, so the module has to answer every message
+// exactly once. Each worker runs one task at a time and waiting tasks are
+// kept in a single FIFO queue that idle workers take from.
+class WorkerPool extends EventEmitter {
+  constructor (createWorker, moduleName, options = {}) {
+    super()
+    this.createWorker = createWorker
+    this.moduleName = moduleName
+    this.size = options.size || Math.max(os.cpus().length - 1, 1)
+    this.maxQueueSize = options.maxQueueSize || Infinity
+    this.closed = false
+
+    this.nextTaskId = 1
+    this.queue = []
+    this.idle = []
+    this.workers = new Set()
+
+    this.completed = 0
+    this.failed = 0
+    this.cancelled = 0
+    this.totalWaitTime = 0
+    this.totalRunTime = 0
+
+    for (let i = 0; i < this.size; i++) {
+      this.addWorker()
+    }
+  }
+
+  // Queues |message| and returns a Promise for the worker's answer. The
+  // Promise has a cancel() method. Rejects right away when the queue is full.
+  run (message, transferList) {
+    let task
+    const promise = new Promise((resolve, reject) => {
+      task = {
+        id: this.nextTaskId++,
+        message,
+        transferList,
+        resolve,
+        reject,
+        queuedAt: Date.now(),
+        startedAt: 0,
+        worker: null
+      }
+    })
+    promise.id = task.id
+    promise.cancel = () => this.cancel(task)
+
+    if (this.closed) {
+      task.reject(new Error('The worker pool is closed'))
+    } else if (this.workers.size === 0) {
+      task.reject(new Error(`No worker could load ${this.moduleName}`))
+    } else if (this.queue.length >= this.maxQueueSize) {
+      task.reject(new Error('The worker pool queue is full'))
+    } else {
+      this.queue.push(task)
+      this.dispatch()
+    }
+    return promise
+  }
+
+  cancel (task) {
+    if (task.worker) {
+      // The only way to stop a running task is to replace its worker.
+      const worker = task.worker
+      task.cancelled = true
+      this.settle(task, null, new Error('The task was cancelled'))
+      this.removeWorker(worker, true)
+    } else {
+      const index = this.queue.indexOf(task)
+      if (index === -1) return false
+      this.queue.splice(index, 1)
+      task.cancelled = true
+      this.settle(task, null, new Error('The task was cancelled'))
+    }
+    this.cancelled++
+    return true
+  }
+
+  // Rejects waiting tasks and stops the workers once they are idle.
+  close () {
+    this.closed = true
+    for (const task of this.queue.splice(0)) {
+      task.reject(new Error('The worker pool is closed'))
+    }
+    for (const worker of this.idle.splice(0)) {
+      this.removeWorker(worker)
+    }
+  }
+
+  getMetrics () {
+    const settled = this.completed + this.failed
+    return {
+      size: this.workers.size,
+      busy: this.workers.size - this.idle.length,
+      queued: this.queue.length,
+      completed: this.completed,
+      failed: this.failed,
+      cancelled: this.cancelled,
+      averageWaitTime: settled ? this.totalWaitTime / settled : 0,
+      averageRunTime: settled ? this.totalRunTime / settled : 0
+    }
+  }
+
+  addWorker () {
+    const worker = this.createWorker(this.moduleName)
+    worker.task = null
+    worker.started = false
+    worker.on('start', () => {
+      worker.started = true
+      this.release(worker)
+    })
+    worker.on('message', (event) => {
+      if (worker.task) this.settle(worker.task, event.data, null)
+      this.release(worker)
+    })
+    worker.on('stop', () => {
+      // Workers that never started failed to load the module, replacing
+      // them would only fail again.
+      this.removeWorker(worker, worker.started)
+    })
+    worker.onerror = (message, stack) => {
+      if (!worker.task) return
+      const error = new Error(message)
+      if (stack) error.stack = stack
+      this.settle(worker.task, null, error)
+      this.release(worker)
+    }
+    this.workers.add(worker)
+    worker.start()
+  }
+
+  removeWorker (worker, replace) {
+    if (!this.workers.has(worker)) return
+    if (replace && !this.closed) this.addWorker()
+    this.workers.delete(worker)
+    const index = this.idle.indexOf(worker)
+    if (index !== -1) this.idle.splice(index, 1)
+    if (worker.task) {
+      this.settle(worker.task, null, new Error('The worker stopped'))
+    }
+    worker.terminate()
+
+    // A module that can not be loaded leaves nothing to run the tasks on.
+    if (this.workers.size === 0) {
+      for (const task of this.queue.splice(0)) {
+        task.reject(new Error(`No worker could load ${this.moduleName}`))
+      }
+    }
+  }
+
+  release (worker) {
+    if (!this.workers.has(worker)) return
+    if (this.closed) {
+      this.removeWorker(worker)
+      return
+    }
+    if (this.idle.indexOf(worker) === -1) this.idle.push(worker)
+    this.dispatch()
+  }
+
+  dispatch () {
+    while (this.queue.length > 0 && this.idle.length > 0) {
+      const task = this.queue.shift()
+      const worker = this.idle.shift()
+      task.worker = worker
+      task.startedAt = Date.now()
+      worker.task = task
+      try {
+        worker.postMessage(task.message, task.transferList)
+      } catch (error) {
+        this.settle(task, null, error)
+        this.idle.unshift(worker)
+      }
+    }
+  }
+
+  settle (task, result, error) {
+    const worker = task.worker
+    if (worker && worker.task === task) worker.task = null
+    task.worker = null
+
+    if (task.startedAt && !task.cancelled) {
+      const now = Date.now()
+      this.totalWaitTime += task.startedAt - task.queuedAt
+      this.totalRunTime += now - task.startedAt
+      if (error) this.failed++
+      else this.completed++
+      this.emit('metrics', this.getMetrics())
+    }
+
+    if (error) task.reject(error)
+    else task.resolve(result)
+  }
+}
+
+module.exports = WorkerPool
@@ -483,14 +483,20 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
-      const buffer = new Buffer(info.size)
+      const storedSize = info.compressedSize != null ? info.compressedSize : info.size
+      const buffer = new Buffer(storedSize)
       const fd = archive.getFd()
       if (!(fd >= 0)) {
         return notFoundError(asarPath, filePath, callback)
       }
       logASARAccess(asarPath, filePath, info.offset)
-      fs.read(fd, buffer, 0, info.size, info.offset, function (error) {
-        callback(error, encoding ? buffer.toString(encoding) : buffer)
+      fs.read(fd, buffer, 0, storedSize, info.offset, function (error) {
+        if (error || info.compressedSize == null) {
+          return callback(error, encoding ? buffer.toString(encoding) : buffer)
+        }
+        require('zlib').gunzip(buffer, function (error, result) {
+          callback(error, encoding && result ? result.toString(encoding) : result)
+        })
       })
     }
 
@@ -531,13 +537,11 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
-      const buffer = new Buffer(info.size)
-      const fd = archive.getFd()
-      if (!(fd >= 0)) {
+      logASARAccess(asarPath, filePath, info.offset)
+      const buffer = archive.readFileBuffer(filePath)
+      if (!buffer) {
         notFoundError(asarPath, filePath)
       }
-      logASARAccess(asarPath, filePath, info.offset)
-      fs.readSync(fd, buffer, 0, info.size, info.offset)
       if (encoding) {
         return buffer.toString(encoding)
       } else {
@@ -604,14 +608,12 @@
           encoding: 'utf8'
         })
       }
-      const buffer = new Buffer(info.size)
-      const fd = archive.getFd()
-      if (!(fd >= 0)) {
+      logASARAccess(asarPath, filePath, info.offset)
+      const source = archive.readFileString(filePath)
+      if (source === false) {
         return
       }
-      logASARAccess(asarPath, filePath, info.offset)
-      fs.readSync(fd, buffer, 0, info.size, info.offset)
-      return buffer.toString('utf8')
+      return source
     }
 
     const {internalModuleStat} = process.binding('fs')
@@ -1,6 +1,6 @@
 const path = requireNative('path')
 
-const commonjs = function (fn, exports, modulePath, __global__) {
+const commonjs = function (fn, exports, modulePath, __global__, scope) {
   // convert module.exports to exports.$set
   const exportsHandler = {
     set: (target, name, value) => {
@@ -66,7 +66,7 @@ const commonjs = function (fn, exports, modulePath, __global__) {
     }
 
     try {
-      fn.apply(__global__, [requireProxy, moduleProxy, console])
+      fn.apply(__global__, [requireProxy, moduleProxy, console].concat(scope || []))
     } catch (e) {
       if (__global__.onerror) {
         __global__.onerror(e)
@@ -77,3 +77,9 @@ const commonjs = function (fn, exports, modulePath, __global__) {
 }
 
 exports.$set('require', commonjs)
+// Runs the module |moduleName| compiled with the code cache of the process.
+// |scope| holds the values of the ModuleSystem names the module is compiled
+// with, which it could use when it was nested in the ModuleSystem wrapper.
+exports.$set('run', (moduleName, moduleExports, modulePath, __global__, scope) => {
+  commonjs(path.compile(moduleName), moduleExports, modulePath, __global__, scope)
+})
@@ -11,7 +11,7 @@ ipcRenderer.send = function (...args) {
 }
 
 ipcRenderer.sendSync = function (...args) {
-  return JSON.parse(binding.sendSync('ipc-message-sync', args))
+  return binding.sendSync('ipc-message-sync', args)
 }
 
 ipcRenderer.sendToHost = function (...args) {
@@ -10,6 +10,14 @@ const callbacksRegistry = new CallbacksRegistry()
 
 const remoteObjectCache = v8Util.createIDWeakMap()
 
+// The latest descriptions of remote prototypes that were seen.
+// id => {id, version, members, proto}
+const prototypeCache = new Map()
+
+// Pending batchAsync calls.
+// requestId => {resolve, reject}
+const pendingBatches = new Map()
+
 // Convert the arguments object into an array of meta data.
 const wrapArgs = function (args, visited) {
   if (visited == null) {
@@ -144,10 +152,25 @@ const setObjectMembers = function (ref, object, metaId, members) {
   }
 }
 
+// Get the description of a remote prototype, fetching the whole chain from
+// the browser when the prototype or its version has not been seen yet.
+const getPrototypeDescriptor = function (protoRef) {
+  let descriptor = prototypeCache.get(protoRef.id)
+  if (descriptor == null || descriptor.version !== protoRef.version) {
+    for (let current of ipcRenderer.sendSync('ELECTRON_BROWSER_PROTOTYPE', protoRef.id)) {
+      prototypeCache.set(current.id, current)
+    }
+    descriptor = prototypeCache.get(protoRef.id)
+  }
+  return descriptor
+}
+
 // Populate object's prototype from descriptor.
 // This matches |getObjectPrototype| in rpc-server.
-const setObjectPrototype = function (ref, object, metaId, descriptor) {
-  if (descriptor === null) return
+const setObjectPrototype = function (ref, object, metaId, protoRef) {
+  if (protoRef == null) return
+  const descriptor = getPrototypeDescriptor(protoRef)
+  if (descriptor == null) return
   let proto = {}
   setObjectMembers(ref, proto, metaId, descriptor.members)
   setObjectPrototype(ref, proto, metaId, descriptor.proto)
@@ -279,6 +302,46 @@ const metaToPlainObject = function (meta) {
   return obj
 }
 
+// Convert batch operations into what rpc-server's |runOperations| expects.
+// The object of an operation is a remote object, or the index of an earlier
+// operation whose result it works on.
+const wrapOperations = function (operations) {
+  return operations.map(function (operation) {
+    const {object} = operation
+    const wrapped = typeof object === 'number'
+      ? {result: object}
+      : {id: object != null ? privates(object).atomId : undefined}
+    if (wrapped.result == null && wrapped.id == null) {
+      throw new TypeError('Batch operations need a remote object or the index of an earlier operation')
+    }
+    if (operation.call != null) {
+      wrapped.type = 'call'
+      wrapped.name = operation.call
+      wrapped.args = wrapArgs(operation.args || [])
+    } else if (operation.set != null) {
+      wrapped.type = 'set'
+      wrapped.name = operation.set
+      wrapped.value = wrapArgs([operation.value])[0]
+    } else {
+      wrapped.type = 'get'
+      wrapped.name = operation.get
+    }
+    return wrapped
+  })
+}
+
+// Browser replies to batchAsync.
+ipcRenderer.on('ELECTRON_RENDERER_BATCH_RESPONSE', function (event, requestId, results) {
+  const pending = pendingBatches.get(requestId)
+  if (!pending) return
+  pendingBatches.delete(requestId)
+  try {
+    pending.resolve(results.map(metaToValue))
+  } catch (error) {
+    pending.reject(error)
+  }
+})
+
 // Browser calls a callback in renderer.
 ipcRenderer.on('ELECTRON_RENDERER_CALLBACK', function (event, id, args) {
   callbacksRegistry.apply(id, metaToValue(args))
@@ -310,6 +373,31 @@ binding.getCurrentWebContents = function () {
   return metaToValue(ipcRenderer.sendSync('ELECTRON_BROWSER_CURRENT_WEB_CONTENTS'))
 }
 
+// Run several gets, sets and calls in one round trip, returning their
+// results. See docs/api/remote.md.
+binding.batch = function (operations) {
+  const results = ipcRenderer.sendSync('ELECTRON_BROWSER_BATCH', wrapOperations(operations))
+  return results.map(metaToValue)
+}
+
+// Like |batch|, but returns a Promise instead of blocking.
+binding.batchAsync = function (operations) {
+  return new Promise(function (resolve, reject) {
+    const wrapped = wrapOperations(operations)
+    const requestId = ipcRenderer.guid()
+    pendingBatches.set(requestId, {resolve, reject})
+    ipcRenderer.send('ELECTRON_BROWSER_BATCH_ASYNC', requestId, wrapped)
+  })
+}
+
+binding.getAsync = function (object, name) {
+  return binding.batchAsync([{object, get: name}]).then((results) => results[0])
+}
+
+binding.callAsync = function (object, name, ...args) {
+  return binding.batchAsync([{object, call: name, args}]).then((results) => results[0])
+}
+
 binding.getWebContents = function (tabId, cb) {
   const responseId = ipcRenderer.guid()
   ipcRenderer.on('ELECTRON_BROWSER_GET_WEB_CONTENTS_RESPONSE_' + responseId, (evt, res) => {
@@ -8,6 +8,7 @@ const {remote} = require('electron')
 const {closeWindow} = require('./window-helpers')
 
 const {app, BrowserWindow, ipcMain} = remote
+const {EventEmitter} = require('events')
 
 describe('electron module', function () {
   it('does not expose internal modules to require', function () {
@@ -334,4 +335,161 @@ describe('app module', function () {
       assert.equal(typeof app.isAccessibilitySupportEnabled(), 'boolean')
     })
   })
+
+  describe('app.getEventEmitterInfo()', function () {
+    let w = null
+
+    afterEach(function () {
+      return closeWindow(w).then(function () { w = null })
+    })
+
+    it('counts events emitted with and without listeners', function (done) {
+      w = new BrowserWindow({show: false})
+      const before = app.getEventEmitterInfo()['did-start-loading'] ||
+        {emitted: 0, skipped: 0}
+      w.webContents.once('did-finish-load', function () {
+        const after = app.getEventEmitterInfo()
+        assert(after['did-finish-load'].emitted > 0)
+        assert(after['did-start-loading'].emitted +
+          after['did-start-loading'].skipped > before.emitted + before.skipped)
+        done()
+      })
+      w.loadURL('about:blank')
+    })
+  })
+
+  describe('app.createWorkerPool(moduleName)', function () {
+    const WorkerPool = require(path.join(process.resourcesPath, 'electron.asar', 'browser', 'worker-pool.js'))
+
+    // Answers every message with |handler(message)| after a tick, or
+    // reports the error it throws.
+    class FakeWorker extends EventEmitter {
+      constructor (handler) {
+        super()
+        this.handler = handler
+        this.running = 0
+        this.terminated = false
+      }
+
+      start () {
+        setImmediate(() => this.emit('start', {}))
+      }
+
+      postMessage (message) {
+        this.running++
+        setImmediate(() => {
+          this.running--
+          if (this.terminated) return
+          let result
+          try {
+            result = this.handler(message)
+          } catch (error) {
+            this.onerror(error.message, error.stack)
+            return
+          }
+          this.emit('message', {data: result})
+        })
+      }
+
+      terminate () {
+        this.terminated = true
+      }
+    }
+
+    let created = null
+
+    const createPool = function (handler, options) {
+      created = []
+      return new WorkerPool(function () {
+        const worker = new FakeWorker(handler)
+        created.push(worker)
+        return worker
+      }, 'fake', options)
+    }
+
+    it('runs every task once on the pooled workers', function () {
+      const pool = createPool((message) => message * 2, {size: 2})
+      const tasks = []
+      for (let i = 0; i < 10; i++) tasks.push(pool.run(i))
+      return Promise.all(tasks).then(function (results) {
+        assert.deepEqual(results, [0, 2, 4, 6, 8, 10, 12, 14, 16, 18])
+        assert.equal(created.length, 2)
+        const metrics = pool.getMetrics()
+        assert.equal(metrics.completed, 10)
+        assert.equal(metrics.queued, 0)
+        assert.equal(metrics.busy, 0)
+        pool.close()
+      })
+    })
+
+    it('rejects tasks whose worker reports an error', function () {
+      const pool = createPool(function (message) {
+        if (message === 'fail') throw new Error('task failed')
+        return message
+      }, {size: 1})
+      const failing = pool.run('fail').then(function () {
+        assert.fail('the task should fail')
+      }, function (error) {
+        assert.equal(error.message, 'task failed')
+      })
+      return Promise.all([failing, pool.run('ok')]).then(function (results) {
+        assert.equal(results[1], 'ok')
+        assert.equal(pool.getMetrics().failed, 1)
+        pool.close()
+      })
+    })
+
+    it('replaces a worker that stops while running a task', function () {
+      const pool = createPool((message) => message, {size: 1})
+      const task = pool.run('lost')
+      setImmediate(function () {
+        created[0].terminated = true
+        created[0].emit('stop', {})
+      })
+      return task.then(function () {
+        assert.fail('the task should fail')
+      }, function (error) {
+        assert.equal(error.message, 'The worker stopped')
+        assert.equal(created.length, 2)
+        return pool.run('next')
+      }).then(function (result) {
+        assert.equal(result, 'next')
+        pool.close()
+      })
+    })
+
+    it('rejects waiting tasks and stops the workers on close', function () {
+      const pool = createPool((message) => message, {size: 1})
+      const running = pool.run('running')
+      const waiting = pool.run('waiting')
+      return new Promise((resolve) => setImmediate(resolve)).then(function () {
+        pool.close()
+        return waiting
+      }).then(function () {
+        assert.fail('the waiting task should be rejected')
+      }, function (error) {
+        assert.equal(error.message, 'The worker pool is closed')
+        return running
+      }).then(function (result) {
+        // The running task finishes before its worker stops.
+        assert.equal(result, 'running')
+        assert(created[0].terminated)
+        return pool.run('late')
+      }).then(function () {
+        assert.fail('tasks should be rejected after close')
+      }, function (error) {
+        assert.equal(error.message, 'The worker pool is closed')
+      })
+    })
+
+    it('rejects tasks when the module can not be loaded', function () {
+      const pool = app.createWorkerPool('electron-spec-missing-module', {size: 2})
+      return pool.run('task').then(function () {
+        assert.fail('the task should fail')
+      }, function (error) {
+        assert(/No worker could load/.test(error.message))
+        pool.close()
+      })
+    })
+  })
 })
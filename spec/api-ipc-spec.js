@@ -322,6 +322,56 @@ describe('ipc module', function () {
       global.gc()
       assert.equal(method(), 'method')
     })
+
+    it('shows members added to a prototype later', function () {
+      const mixin = remote.require(path.join(fixtures, 'module', 'mixin.js'))
+      assert.equal(mixin.create().mixedIn, undefined)
+      assert.equal(mixin.createDerived().mixedIn, undefined)
+
+      mixin.addMethod('mixedIn')
+      assert.equal(mixin.create().mixedIn(), 'mixedIn')
+      assert.equal(mixin.createDerived().mixedIn(), 'mixedIn')
+    })
+  })
+
+  describe('remote.batch', function () {
+    const cl = remote.require(path.join(fixtures, 'module', 'class.js'))
+
+    it('runs several operations at once', function () {
+      const results = remote.batch([
+        {object: cl.base, call: 'method'},
+        {object: cl.base, get: 'readonly'},
+        {object: cl.base, set: 'value', value: 'batched'},
+        {object: cl.base, get: 'value'},
+        {object: cl.base, set: 'value', value: 'old'}
+      ])
+      assert.deepEqual(results, ['method', 'readonly', undefined, 'batched', undefined])
+    })
+
+    it('can work on the results of earlier operations', function () {
+      const property = remote.require(path.join(fixtures, 'module', 'property.js'))
+      const results = remote.batch([
+        {object: property, get: 'func'},
+        {object: 0, get: 'property'}
+      ])
+      assert.equal(results[1], 'foo')
+    })
+
+    it('throws errors raised by operations', function () {
+      assert.throws(function () {
+        remote.batch([{object: cl.base, call: 'missing'}])
+      })
+    })
+
+    it('has asynchronous variants', function () {
+      return Promise.all([
+        remote.getAsync(cl.derived, 'readonly'),
+        remote.callAsync(cl.derived, 'method'),
+        remote.batchAsync([{object: cl.base, get: 'value'}])
+      ]).then(function (results) {
+        assert.deepEqual(results, ['readonly', 'method', ['old']])
+      })
+    })
   })
 
   describe('ipc.sender.send', function () {
@@ -340,12 +390,78 @@ describe('ipc module', function () {
     it('can send instances of Date', function (done) {
       const currentDate = new Date()
       ipcRenderer.once('message', function (event, value) {
-        assert.equal(value, currentDate.toISOString())
+        assert.ok(value instanceof Date)
+        assert.equal(value.getTime(), currentDate.getTime())
         done()
       })
       ipcRenderer.send('message', currentDate)
     })
 
+    it('can send typed arrays, maps and sets', function (done) {
+      const floats = new Float64Array([1.5, -2.25, Infinity])
+      const map = new Map([['a', 1], ['b', 2]])
+      const set = new Set([1, 'two'])
+      ipcRenderer.once('message', function (event, floatsValue, mapValue, setValue) {
+        assert.ok(floatsValue instanceof Float64Array)
+        assert.deepEqual(Array.from(floatsValue), Array.from(floats))
+        assert.deepEqual(Array.from(mapValue), Array.from(map))
+        assert.deepEqual(Array.from(setValue), Array.from(set))
+        done()
+      })
+      ipcRenderer.send('message', floats, map, set)
+    })
+
+    for (const size of [1024, 100 * 1024, 10 * 1024 * 1024]) {
+      it(`can send ${size} byte payloads`, function (done) {
+        const bytes = new Uint8Array(size)
+        for (let i = 0; i < size; i += 997) bytes[i] = i % 256
+        ipcRenderer.once('message', function (event, value) {
+          assert.equal(value.length, size)
+          assert.ok(Buffer.from(bytes.buffer).equals(Buffer.from(value)))
+          done()
+        })
+        ipcRenderer.send('message', bytes)
+      })
+
+      it(`reports round trip times of ${size} byte payloads`, function () {
+        this.timeout(120000)
+        const bytes = new Uint8Array(size)
+        const count = size > 1024 * 1024 ? 5 : 50
+
+        // Resolves with the mean time in milliseconds of a round trip of
+        // |bytes| through |channel|, after one to warm up.
+        const measure = function (channel, ...extraArgs) {
+          return new Promise(function (resolve) {
+            let start = null
+            let remaining = count + 1
+            const onMessage = function (event, value) {
+              assert.equal(value.length, size)
+              if (start === null) start = window.performance.now()
+              if (--remaining > 0) {
+                ipcRenderer.send(channel, bytes, ...extraArgs)
+                return
+              }
+              ipcRenderer.removeListener(channel, onMessage)
+              resolve((window.performance.now() - start) / count)
+            }
+            ipcRenderer.on(channel, onMessage)
+            ipcRenderer.send(channel, bytes, ...extraArgs)
+          })
+        }
+
+        let serialized = null
+        return measure('message').then(function (time) {
+          serialized = time
+          // A function can not be cloned, so it forces the ListValue path.
+          return measure('list-value-message', function () {})
+        }).then(function (listValue) {
+          console.log(`${size} byte round trip: ` +
+            `serialized ${serialized.toFixed(3)}ms, ` +
+            `ListValue ${listValue.toFixed(3)}ms`)
+        })
+      })
+    }
+
     it('can send instances of Buffer', function (done) {
       const buffer = Buffer.from('hello')
       ipcRenderer.once('message', function (event, message) {
@@ -403,7 +519,7 @@ describe('ipc module', function () {
       ipcRenderer.send('message', array, foo, bar, child)
     })
 
-    it('inserts null for cyclic references', function (done) {
+    it('keeps cyclic references', function (done) {
       const array = [5]
       array.push(array)
 
@@ -412,15 +528,27 @@ describe('ipc module', function () {
 
       ipcRenderer.once('message', function (event, arrayValue, childValue) {
         assert.equal(arrayValue[0], 5)
-        assert.equal(arrayValue[1], null)
+        assert.strictEqual(arrayValue[1], arrayValue)
 
         assert.equal(childValue.hello, 'world')
-        assert.equal(childValue.child, null)
+        assert.strictEqual(childValue.child, childValue)
 
         done()
       })
       ipcRenderer.send('message', array, child)
     })
+
+    it('inserts null for cyclic references that can not be cloned', function (done) {
+      const array = [5, function () {}]
+      array.push(array)
+
+      ipcRenderer.once('message', function (event, arrayValue) {
+        assert.equal(arrayValue[0], 5)
+        assert.equal(arrayValue[2], null)
+        done()
+      })
+      ipcRenderer.send('message', array)
+    })
   })
 
   describe('ipc.sendSync', function () {
@@ -433,6 +561,21 @@ describe('ipc module', function () {
       assert.equal(msg, 'test')
     })
 
+    it('replies with structured clones', function () {
+      const date = new Date()
+      const value = ipcRenderer.sendSync('echo', {date, floats: new Float32Array([0.5, 2])})
+      assert.ok(value.date instanceof Date)
+      assert.equal(value.date.getTime(), date.getTime())
+      assert.deepEqual(Array.from(value.floats), [0.5, 2])
+    })
+
+    it('replies with values that can not be cloned through JSON', function () {
+      ipcMain.once('send-sync-message', function (event) {
+        event.returnValue = {name: 'value', fn: function () {}}
+      })
+      assert.deepEqual(ipcRenderer.sendSync('send-sync-message'), {name: 'value'})
+    })
+
     it('does not crash when reply is not sent and browser is destroyed', function (done) {
       this.timeout(10000)
 
@@ -461,6 +604,47 @@ describe('ipc module', function () {
     })
   })
 
+  describe('remote call latency', function () {
+    const count = 500
+
+    // Returns the mean time of |count| calls of |fn| in milliseconds.
+    const measure = function (fn) {
+      fn()
+      const start = window.performance.now()
+      for (let i = 0; i < count; i++) fn()
+      return (window.performance.now() - start) / count
+    }
+
+    afterEach(function () {
+      ipcMain.removeAllListeners('latency-message')
+    })
+
+    it('reports remote property reads and sync replies', function () {
+      this.timeout(60000)
+
+      const remotePath = remote.require('path')
+      const reads = measure(() => remotePath.sep)
+      assert.equal(remotePath.sep, path.sep)
+
+      const reply = {name: 'value', list: [1, 2, 3], nested: {flag: true}}
+      ipcMain.on('latency-message', function (event, json) {
+        event.returnValue = json ? JSON.stringify(reply) : reply
+      })
+      // Sync replies used to be stringified in the browser, sent as a
+      // string and parsed in the renderer. The string is cloned now, so this
+      // does the same work except for writing it as a string16.
+      const sendJSON = () => JSON.parse(ipcRenderer.sendSync('latency-message', true))
+      const cloned = measure(() => ipcRenderer.sendSync('latency-message', false))
+      const json = measure(sendJSON)
+      assert.deepEqual(ipcRenderer.sendSync('latency-message', false), reply)
+      assert.deepEqual(sendJSON(), reply)
+
+      console.log(`remote property read: ${reads.toFixed(3)}ms, ` +
+        `cloned sync reply: ${cloned.toFixed(3)}ms, ` +
+        `stringified and parsed sync reply: ${json.toFixed(3)}ms`)
+    })
+  })
+
   describe('ipcRenderer.sendTo', function () {
     let contents = null
     beforeEach(function () {
@@ -1,7 +1,10 @@
 const assert = require('assert')
+const ChildProcess = require('child_process')
 const http = require('http')
+const https = require('https')
 const path = require('path')
 const fs = require('fs')
+const temp = require('temp').track()
 const {closeWindow} = require('./window-helpers')
 
 const {ipcRenderer, remote} = require('electron')
@@ -402,4 +405,137 @@ describe('session module', function () {
       })
     })
   })
+
+  describe('session.getSharedNetworkSessionInfo(callback)', function () {
+    let server = null
+
+    afterEach(function () {
+      if (server) server.close()
+      server = null
+    })
+
+    it('can not be used by persistent partitions', function () {
+      assert.throws(function () {
+        session.fromPartition('persist:shared-network', {shared_network_session: true})
+      }, /in-memory partitions/)
+    })
+
+    it('shares the network session but not cookies', function (done) {
+      server = http.createServer(function (req, res) {
+        res.setHeader('Set-Cookie', 'shared=' + req.url.substr(1))
+        res.end('<html></html>')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        const port = server.address().port
+        const ses1 = session.fromPartition('shared-network-1', {shared_network_session: true})
+        const ses2 = session.fromPartition('shared-network-2', {shared_network_session: true})
+        const w2 = new BrowserWindow({show: false, webPreferences: {session: ses2}})
+        w.destroy()
+        w = new BrowserWindow({show: false, webPreferences: {session: ses1}})
+        w.loadURL(`${url}:${port}/one`)
+        w.webContents.once('did-finish-load', function () {
+          w2.loadURL(`${url}:${port}/two`)
+          w2.webContents.once('did-finish-load', function () {
+            ses1.cookies.get({name: 'shared'}, function (error, cookies) {
+              assert.ifError(error)
+              assert.equal(cookies[0].value, 'one')
+              session.getSharedNetworkSessionInfo(function (info) {
+                assert(info.partitions >= 2)
+                assert(info.hostCacheEntries >= 0)
+                // The second session reuses the keep-alive connection of the
+                // first one.
+                assert(info.reusedConnections >= 1)
+                assert.equal(info.tlsHandshakes, 0)
+                closeWindow(w2).then(function () { done() })
+              })
+            })
+          })
+        })
+      })
+    })
+  })
+
+  describe('network state persistence', function () {
+    this.timeout(60000)
+
+    const appPath = path.join(fixtures, 'api', 'network-state')
+    const certPath = path.join(fixtures, 'certificates')
+    let server = null
+    let port = null
+
+    before(function (done) {
+      const options = {
+        key: fs.readFileSync(path.join(certPath, 'server.key')),
+        cert: fs.readFileSync(path.join(certPath, 'server.pem'))
+      }
+      server = https.createServer(options, function (req, res) {
+        res.setHeader('Strict-Transport-Security', 'max-age=3600')
+        res.setHeader('Alt-Svc', `h2=":${port}"; ma=3600`)
+        res.end('<html></html>')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        port = server.address().port
+        done()
+      })
+    })
+
+    after(function () {
+      server.close()
+    })
+
+    // Runs the app and resolves with the JSON it prints before quitting.
+    function runApp (userData, partition, mode) {
+      return new Promise(function (resolve, reject) {
+        const args = [appPath, userData, partition, mode, String(port)]
+        const child = ChildProcess.spawn(remote.process.execPath, args)
+        let output = ''
+        child.stdout.on('data', function (data) { output += data })
+        child.on('error', reject)
+        child.on('exit', function () {
+          const lines = output.trim().split('\n')
+          try {
+            resolve(JSON.parse(lines[lines.length - 1]))
+          } catch (error) {
+            reject(new Error(`Unexpected output: ${output}`))
+          }
+        })
+      })
+    }
+
+    function listFiles (dir) {
+      return ['Network Persistent State', 'TransportSecurity'].filter(function (file) {
+        return fs.existsSync(path.join(dir, file))
+      })
+    }
+
+    it('writes the state of persistent partitions and enforces HSTS after a restart', function () {
+      const userData = temp.mkdirSync('electron-network-state')
+      const dir = path.join(userData, 'Partitions', 'network-state')
+      return runApp(userData, 'persist:network-state', 'visit').then(function (result) {
+        assert.deepEqual(result, {files: ['Network Persistent State', 'TransportSecurity']})
+        assert.deepEqual(listFiles(dir), ['Network Persistent State', 'TransportSecurity'])
+        const properties = JSON.parse(fs.readFileSync(path.join(dir, 'Network Persistent State')))
+        assert(JSON.stringify(properties).includes(`hsts.test:${port}`))
+        return runApp(userData, 'persist:network-state', 'check')
+      }).then(function (result) {
+        // The HTTP URL is upgraded before any request is made, and the page
+        // is then served by the HTTPS server.
+        assert.equal(result.redirectURL, `https://hsts.test:${port}/`)
+        assert.equal(result.url, `https://hsts.test:${port}/`)
+      })
+    })
+
+    it('writes nothing for in-memory partitions', function () {
+      const userData = temp.mkdirSync('electron-network-state')
+      return runApp(userData, 'network-state', 'visit').then(function (result) {
+        assert.deepEqual(result, {files: []})
+        assert.deepEqual(listFiles(userData), [])
+        assert(!fs.existsSync(path.join(userData, 'Partitions')))
+        return runApp(userData, 'network-state', 'check')
+      }).then(function (result) {
+        assert.equal(result.redirectURL, null)
+        assert.notEqual(result.error, undefined)
+      })
+    })
+  })
 })
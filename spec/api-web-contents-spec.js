@@ -97,4 +97,41 @@ describe('webContents module', function () {
       })
     })
   })
+
+  describe('setEventBatching() API', function () {
+    it('delivers resource events in one event-batch', function (done) {
+      const events = []
+      w.webContents.setEventBatching(true, 100)
+      w.webContents.on('did-get-response-details', function () {
+        done(new Error('did-get-response-details was not batched'))
+      })
+      w.webContents.on('event-batch', function (e, batch) {
+        events.push(...batch)
+      })
+      w.webContents.once('did-finish-load', function () {
+        const names = events.map((event) => event[0])
+        assert.notEqual(names.indexOf('did-get-response-details'), -1)
+        const info = w.webContents.getEventBatchingInfo()
+        assert.equal(info.enabled, true)
+        assert.equal(info.interval, 100)
+        assert.equal(info.events, events.length)
+        done()
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'did-get-response-details.html'))
+    })
+
+    it('emits events one by one without an event-batch listener', function (done) {
+      let responses = 0
+      w.webContents.setEventBatching(true, 100)
+      w.webContents.on('did-get-response-details', function () {
+        responses++
+      })
+      w.webContents.once('did-finish-load', function () {
+        assert.notEqual(responses, 0)
+        assert.equal(w.webContents.getEventBatchingInfo().events, 0)
+        done()
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'did-get-response-details.html'))
+    })
+  })
 })
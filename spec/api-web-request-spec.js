@@ -1,8 +1,10 @@
 const assert = require('assert')
 const http = require('http')
+const path = require('path')
 const qs = require('querystring')
+const {closeWindow} = require('./window-helpers')
 const remote = require('electron').remote
-const session = remote.session
+const {BrowserWindow, session} = remote
 
 describe('webRequest module', function () {
   var ses = session.defaultSession
@@ -85,6 +87,55 @@ describe('webRequest module', function () {
       })
     })
 
+    it('can filter URLs by host among many patterns', function (done) {
+      var urls = ['http://*.example.com/*', 'http://127.0.0.1/filter/*']
+      for (var i = 0; i < 1000; i++) {
+        urls.push('http://host' + i + '.test/*')
+      }
+      ses.webRequest.onBeforeRequest({urls: urls}, function (details, callback) {
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL + 'nofilter/test',
+        success: function (data) {
+          assert.equal(data, '/nofilter/test')
+          $.ajax({
+            url: defaultURL + 'filter/test',
+            success: function () {
+              done('unexpected success')
+            },
+            error: function () {
+              done()
+            }
+          })
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('only fills in the requested fields', function (done) {
+      ses.webRequest.onBeforeRequest({fields: ['url', 'resourceType']}, function (details, callback) {
+        assert.deepEqual(Object.keys(details).sort(), ['resourceType', 'url'])
+        assert.equal(details.url, defaultURL)
+        assert.equal(details.resourceType, 'xhr')
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
     it('receives details object', function (done) {
       ses.webRequest.onBeforeRequest(function (details, callback) {
         assert.equal(typeof details.id, 'number')
@@ -419,6 +470,7 @@ describe('webRequest module', function () {
         assert.equal(typeof details.fromCache, 'boolean')
         assert.equal(details.statusLine, 'HTTP/1.1 200 OK')
         assert.equal(details.statusCode, 200)
+        assert.equal(details.protocol, 'http/1.1')
       })
       $.ajax({
         url: defaultURL,
@@ -457,4 +509,225 @@ describe('webRequest module', function () {
       })
     })
   })
+
+  describe('webRequest.setRules', function () {
+    afterEach(function () {
+      ses.webRequest.setRules(null)
+      ses.webRequest.onBeforeRequest(null)
+    })
+
+    it('blocks matching requests without a listener', function (done) {
+      ses.webRequest.setRules([
+        {urls: ['http://127.0.0.1/block/*'], action: 'block'}
+      ])
+      $.ajax({
+        url: defaultURL + 'allow/test',
+        success: function (data) {
+          assert.equal(data, '/allow/test')
+          $.ajax({
+            url: defaultURL + 'block/test',
+            success: function () {
+              done('unexpected success')
+            },
+            error: function () {
+              done()
+            }
+          })
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('falls back to the listener when no rule decides', function (done) {
+      ses.webRequest.setRules([
+        {urls: ['http://127.0.0.1/block/*'], action: 'block'}
+      ])
+      ses.webRequest.onBeforeRequest(function (details, callback) {
+        assert.equal(details.url, defaultURL + 'listener')
+        callback({cancel: true})
+      })
+      $.ajax({
+        url: defaultURL + 'listener',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('can set request headers', function (done) {
+      ses.webRequest.setRules([
+        {setRequestHeaders: {Accept: '*/*;test/header'}}
+      ])
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/header/received')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('still calls the header listeners', function (done) {
+      ses.webRequest.setRules([
+        {setRequestHeaders: {Accept: '*/*;test/header'}}
+      ])
+      ses.webRequest.onBeforeSendHeaders(function (details, callback) {
+        assert.equal(details.requestHeaders.Accept, '*/*;test/header')
+        callback({requestHeaders: details.requestHeaders})
+      })
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          ses.webRequest.onBeforeSendHeaders(null)
+          assert.equal(data, '/header/received')
+          done()
+        },
+        error: function (xhr, errorType) {
+          ses.webRequest.onBeforeSendHeaders(null)
+          done(errorType)
+        }
+      })
+    })
+
+    it('throws on invalid rules', function () {
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'explode'}])
+      })
+      assert.throws(function () {
+        ses.webRequest.setRules([{resourceTypes: ['scripts'], action: 'block'}])
+      })
+    })
+
+    describe('with an extension listener', function () {
+      let extensionId = null
+
+      before(function (done) {
+        remote.process.once('extension-ready', function (installInfo) {
+          extensionId = installInfo.id
+          done()
+        })
+        ses.extensions.load(path.join(__dirname, 'fixtures', 'extensions', 'web-request'), {}, 'unpacked')
+      })
+
+      after(function () {
+        ses.extensions.disable(extensionId)
+      })
+
+      // The background page registers its listener some time after the
+      // extension is ready.
+      const waitForListener = function (callback) {
+        $.ajax({
+          url: defaultURL + 'extension-probe',
+          success: function () {
+            setTimeout(waitForListener, 100, callback)
+          },
+          error: function () {
+            callback()
+          }
+        })
+      }
+
+      it('blocks matching requests', function (done) {
+        ses.webRequest.setRules([
+          {urls: ['http://127.0.0.1/block/*'], action: 'block'}
+        ])
+        waitForListener(function () {
+          $.ajax({
+            url: defaultURL + 'allow/test',
+            success: function (data) {
+              assert.equal(data, '/allow/test')
+              $.ajax({
+                url: defaultURL + 'block/test',
+                success: function () {
+                  done('unexpected success')
+                },
+                error: function () {
+                  done()
+                }
+              })
+            },
+            error: function (xhr, errorType) {
+              done(errorType)
+            }
+          })
+        })
+      })
+    })
+  })
+
+  describe('over QUIC', function () {
+    // Served by net's quic_server, see spec/static/main.js.
+    const quicOrigin = remote.getGlobal('quicOrigin')
+    const quicSession = session.fromPartition('quic-web-request', {quic: true})
+    let w = null
+
+    before(function () {
+      if (!quicOrigin) this.skip()
+      // The test certificate is not trusted by the system.
+      quicSession.setCertificateVerifyProc(function (hostname, certificate, callback) {
+        callback(true)
+      })
+    })
+
+    after(function () {
+      quicSession.setCertificateVerifyProc(null)
+    })
+
+    beforeEach(function () {
+      w = new BrowserWindow({
+        show: false,
+        webPreferences: {session: quicSession}
+      })
+    })
+
+    afterEach(function () {
+      quicSession.webRequest.onBeforeRequest(null)
+      quicSession.webRequest.onCompleted(null)
+      quicSession.webRequest.setRules(null)
+      return closeWindow(w).then(function () { w = null })
+    })
+
+    const expectBlocked = function (done) {
+      w.webContents.once('did-finish-load', function () {
+        done('unexpected load')
+      })
+      w.webContents.once('did-fail-load', function (event, errorCode) {
+        assert.equal(errorCode, -20) // net::ERR_BLOCKED_BY_CLIENT
+        done()
+      })
+      w.loadURL(quicOrigin + '/blocked')
+    }
+
+    it('loads over QUIC', function (done) {
+      quicSession.webRequest.onCompleted(function (details) {
+        if (details.url !== quicOrigin + '/allowed') return
+        assert.ok(/quic/.test(details.protocol), details.protocol)
+        assert.equal(details.statusCode, 200)
+        done()
+      })
+      w.loadURL(quicOrigin + '/allowed')
+    })
+
+    it('cancels requests in onBeforeRequest', function (done) {
+      quicSession.webRequest.onBeforeRequest(function (details, callback) {
+        callback({cancel: details.url === quicOrigin + '/blocked'})
+      })
+      expectBlocked(done)
+    })
+
+    it('blocks requests matching rules', function (done) {
+      quicSession.webRequest.setRules([
+        {urls: [quicOrigin + '/blocked'], action: 'block'}
+      ])
+      expectBlocked(done)
+    })
+  })
 })
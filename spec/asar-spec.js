@@ -44,6 +44,13 @@ describe('asar package', function () {
         assert.equal(buffer.toString(), '')
       })
 
+      it('reads a compressed file', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'file1')
+        assert.equal(fs.readFileSync(p).toString().trim(), 'file1')
+        p = path.join(fixtures, 'asar', 'compressed.asar', 'plain')
+        assert.equal(fs.readFileSync(p, 'utf8').trim(), 'plain')
+      })
+
       it('reads a linked file', function () {
         var p = path.join(fixtures, 'asar', 'a.asar', 'link1')
         assert.equal(fs.readFileSync(p).toString().trim(), 'file1')
@@ -90,6 +97,15 @@ describe('asar package', function () {
         })
       })
 
+      it('reads a compressed file', function (done) {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'file1')
+        fs.readFile(p, 'utf8', function (err, content) {
+          assert.equal(err, null)
+          assert.equal(content.trim(), 'file1')
+          done()
+        })
+      })
+
       it('reads from a empty file', function (done) {
         var p = path.join(fixtures, 'asar', 'empty.asar', 'file1')
         fs.readFile(p, function (err, content) {
@@ -766,6 +782,14 @@ describe('asar package', function () {
       })
     })
 
+    it('can request a compressed file in package', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'compressed.asar', 'index.html')
+      $.get('file://' + p, function (data) {
+        assert.equal(data.split('\n')[0], '<html><body>compressed</body></html>')
+        done()
+      })
+    })
+
     it('can request a file in package with unpacked files', function (done) {
       var p = path.resolve(fixtures, 'asar', 'unpack.asar', 'a.txt')
       $.get('file://' + p, function (data) {
@@ -922,6 +946,19 @@ describe('asar package', function () {
     })
   })
 
+  describe('process.getAsarCacheInfo', function () {
+    it('counts archive cache hits', function () {
+      var p = path.join(fixtures, 'asar', 'logo.asar', 'logo.png')
+      nativeImage.createFromPath(p)
+      var before = process.getAsarCacheInfo()
+      nativeImage.createFromPath(p)
+      var after = process.getAsarCacheInfo()
+      assert.equal(after.hits, before.hits + 1)
+      assert.equal(after.opens, before.opens)
+      assert.ok(after.size <= after.capacity || after.capacity === 0)
+    })
+  })
+
   describe('native-image', function () {
     it('reads image from asar archive', function () {
       var p = path.join(fixtures, 'asar', 'logo.asar', 'logo.png')
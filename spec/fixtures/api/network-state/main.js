@@ -0,0 +1,67 @@
+// Usage: electron network-state <userData> <partition> <visit|check> <port>
+//
+// "visit" loads an HTTPS page that sets HSTS and Alt-Svc headers, flushes the
+// session and reports which network state files its directory holds. "check"
+// loads the same origin over HTTP and reports whether it was upgraded.
+const fs = require('fs')
+const path = require('path')
+const {app, session, BrowserWindow} = require('electron')
+
+const [userData, partition, mode, port] = process.argv.slice(2)
+const files = ['Network Persistent State', 'TransportSecurity']
+
+app.setPath('userData', userData)
+app.commandLine.appendSwitch('host-rules', 'MAP hsts.test 127.0.0.1')
+
+let finished = false
+
+function finish (result) {
+  if (finished) return
+  finished = true
+  console.log(JSON.stringify(result))
+  app.quit()
+}
+
+function listFiles () {
+  const name = partition.replace(/^persist:/, '').toLowerCase()
+  const dir = partition.startsWith('persist:')
+    ? path.join(userData, 'Partitions', name) : userData
+  return files.filter((file) => fs.existsSync(path.join(dir, file)))
+}
+
+// The files are written on a background sequence, so wait for them for a
+// while before reporting what is there.
+function waitForFiles (callback, attempts = 50) {
+  const found = listFiles()
+  if (found.length === files.length || attempts === 0) return callback(found)
+  setTimeout(() => waitForFiles(callback, attempts - 1), 200)
+}
+
+app.on('ready', function () {
+  const ses = session.fromPartition(partition)
+  ses.setCertificateVerifyProc((request, callback) => callback(true))
+  const w = new BrowserWindow({show: false, webPreferences: {session: ses}})
+
+  if (mode === 'visit') {
+    w.webContents.once('did-finish-load', function () {
+      ses.flushStorageData()
+      waitForFiles((found) => finish({files: found}))
+    })
+    w.webContents.once('did-fail-load', function (event, code) {
+      finish({error: code})
+    })
+    w.loadURL(`https://hsts.test:${port}/`)
+  } else {
+    let redirectURL = null
+    ses.webRequest.onBeforeRedirect(function (details) {
+      redirectURL = details.redirectURL
+    })
+    w.webContents.once('did-finish-load', function () {
+      finish({redirectURL, url: w.webContents.getURL()})
+    })
+    w.webContents.once('did-fail-load', function (event, code) {
+      finish({redirectURL, error: code})
+    })
+    w.loadURL(`http://hsts.test:${port}/`)
+  }
+})
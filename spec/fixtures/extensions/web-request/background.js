@@ -0,0 +1,5 @@
+// Lets everything through except the probe, which tells the spec that the
+// listener is in place.
+chrome.webRequest.onBeforeRequest.addListener(function (details) {
+  return {cancel: details.url.endsWith('/extension-probe')}
+}, {urls: ['<all_urls>']}, ['blocking'])
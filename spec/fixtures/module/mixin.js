@@ -0,0 +1,21 @@
+'use strict'
+
+class Mixed {
+}
+
+class DerivedMixed extends Mixed {
+}
+
+module.exports = {
+  create () {
+    return new Mixed()
+  },
+  createDerived () {
+    return new DerivedMixed()
+  },
+  addMethod (name) {
+    Mixed.prototype[name] = function () {
+      return name
+    }
+  }
+}
@@ -173,6 +173,19 @@ describe('node feature', function () {
         })
       })
     })
+
+    describe('process.getUvLoopInfo', function () {
+      it('counts wakeups of the browser main thread', function (done) {
+        var before = remote.process.getUvLoopInfo()
+        remote.getGlobal('setTimeout')(function () {
+          var after = remote.process.getUvLoopInfo()
+          assert.ok(after.wakeups > before.wakeups)
+          assert.ok(after.iterations >= after.wakeups)
+          assert.ok(after.maxLatency >= after.averageLatency)
+          done()
+        }, 10)
+      })
+    })
   })
 
   describe('net.connect', function () {
@@ -10,6 +10,7 @@ const BrowserWindow = electron.BrowserWindow
 const protocol = electron.protocol
 
 const Coverage = require('electabul').Coverage
+const childProcess = require('child_process')
 const fs = require('fs')
 const path = require('path')
 const url = require('url')
@@ -28,6 +29,44 @@ app.commandLine.appendSwitch('js-flags', '--expose_gc')
 app.commandLine.appendSwitch('ignore-certificate-errors')
 app.commandLine.appendSwitch('disable-renderer-backgrounding')
 
+// Serves spec/fixtures/quic over QUIC with net's quic_server, when it was
+// built next to the app, for the webRequest specs of sessions with `quic`.
+global.quicOrigin = null
+startQuicServer()
+
+function startQuicServer () {
+  const outDir = process.platform === 'darwin'
+    ? path.resolve(process.execPath, '..', '..', '..', '..')
+    : path.dirname(process.execPath)
+  const serverPath = path.join(outDir,
+    process.platform === 'win32' ? 'quic_server.exe' : 'quic_server')
+  const certsDir = path.resolve(__dirname, '..', '..', '..',
+    'net', 'data', 'ssl', 'certificates')
+  if (!fs.existsSync(serverPath) || !fs.existsSync(certsDir)) return
+
+  const port = 6121
+  const server = childProcess.spawn(serverPath, [
+    `--port=${port}`,
+    `--quic_response_cache_dir=${path.join(__dirname, '..', 'fixtures', 'quic')}`,
+    `--certificate_file=${path.join(certsDir, 'quic_test.example.com.crt')}`,
+    `--key_file=${path.join(certsDir, 'quic_test.example.com.key.pkcs8')}`
+  ], {stdio: 'ignore'})
+  const stopped = function () {
+    global.quicOrigin = null
+  }
+  server.on('error', stopped)
+  server.on('exit', stopped)
+  app.on('quit', function () {
+    server.kill()
+  })
+
+  // The test certificate is issued for www.example.org, so requests to it
+  // are sent to the server, and only over QUIC.
+  app.commandLine.appendSwitch('origin-to-force-quic-on', 'www.example.org:443')
+  app.commandLine.appendSwitch('host-rules', `MAP www.example.org 127.0.0.1:${port}`)
+  global.quicOrigin = 'https://www.example.org'
+}
+
 // Accessing stdout in the main process will result in the process.stdout
 // throwing UnknownSystemError in renderer process sometimes. This line makes
 // sure we can reproduce it in renderer process.
@@ -40,6 +79,11 @@ ipcMain.on('message', function (event, ...args) {
   event.sender.send('message', ...args)
 })
 
+// Echoes through the ListValue messages, since a function can not be cloned.
+ipcMain.on('list-value-message', function (event, ...args) {
+  event.sender.send('list-value-message', ...args, function () {})
+})
+
 // Set productName so getUploadedReports() uses the right directory in specs
 if (process.platform === 'win32') {
   crashReporter.productName = 'Zombies'